@@ -0,0 +1,398 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+use Getopt::Long qw(:config no_ignore_case);
+use JSON::PP;
+use Time::HiRes qw(time);
+use Cwd qw(abs_path);
+
+my ($specFile, $workdir, $names, $baseline, $report, $help);
+my ($dmrg, $toolbox, $sOptions);
+my $tolerance = 0.1;
+my $minSeconds = 0.5;
+my $seed = 1234;
+GetOptions(
+'f=s' => \$specFile,
+'w=s' => \$workdir,
+'n=s' => \$names,
+'b=s' => \$baseline,
+'r=s' => \$report,
+'t=f' => \$tolerance,
+'m=f' => \$minSeconds,
+'s=i' => \$seed,
+'dmrg=s' => \$dmrg,
+'toolbox=s' => \$toolbox,
+'o=s' => \$sOptions,
+'h' => \$help) or die "$0: Error in command line args, run with -h to display help\n";
+
+if (defined($help)) {
+	print "USAGE: $0 [options]\n";
+	print "\tRuns the benchmarks in benchmarks/benchmarks.txt and writes\n";
+	print "\ta report in JSON and CSV. Each run records wall time, peak RSS,\n";
+	print "\ttime per phase (SolverOptions=PhaseTimings) and matvec throughput.\n";
+	print "\t-f file\n";
+	print "\t\tUse file as list of benchmarks instead of benchmarks/benchmarks.txt\n";
+	print "\t-n name1,name2,...\n";
+	print "\t\tRun only the benchmarks named\n";
+	print "\t-w workdir\n";
+	print "\t\tRun in workdir instead of bench\n";
+	print "\t-r report\n";
+	print "\t\tWrite report.json and report.csv; defaults to report\n";
+	print "\t-b baseline.json\n";
+	print "\t\tCompare against baseline.json, a report of a previous run,\n";
+	print "\t\tand exit with status 1 if there are regressions\n";
+	print "\t-t tolerance\n";
+	print "\t\tRelative tolerance for the comparison, defaults to 0.1\n";
+	print "\t-m seconds\n";
+	print "\t\tTimes below seconds in both runs are not compared, defaults to 0.5\n";
+	print "\t-s seed\n";
+	print "\t\tRandomSeed of all benchmarks, defaults to 1234\n";
+	print "\t-o options\n";
+	print "\t\tAppend options to SolverOptions of all benchmarks\n";
+	print "\t--dmrg path and --toolbox path\n";
+	print "\t\tExecutables to use, default to ../src/dmrg and ../src/toolboxdmrg\n";
+	print "\t-h\n";
+	print "\t\tPrint this help and exit\n";
+	exit(0);
+}
+
+defined($specFile) or $specFile = "benchmarks/benchmarks.txt";
+defined($workdir) or $workdir = "bench";
+defined($report) or $report = "report";
+defined($dmrg) or $dmrg = "../src/dmrg";
+defined($toolbox) or $toolbox = "../src/toolboxdmrg";
+defined($sOptions) or $sOptions = "";
+
+my %only;
+if (defined($names)) {
+	$only{$_} = 1 for (split(/,/, $names));
+}
+
+my $specDir = $specFile;
+$specDir =~ s/[^\/]*$//;
+$specDir = "./" if ($specDir eq "");
+
+my @benchmarks = readSpec($specFile);
+my $timeCommand = findTime();
+
+prepareDir();
+
+my @runs;
+foreach my $bench (@benchmarks) {
+	next if (defined($names) and !defined($only{$bench->{"name"}}));
+	foreach my $m (@{$bench->{"m"}}) {
+		push @runs, runOne($bench, $m);
+	}
+}
+
+die "$0: No benchmarks run\n" if (scalar(@runs) == 0);
+
+my $json = JSON::PP->new->canonical(1)->pretty;
+writeFile("$report.json", $json->encode({"runs" => \@runs}));
+writeCsv("$report.csv", \@runs);
+print "$0: Report written to $workdir/$report.json and $workdir/$report.csv\n";
+
+exit(0) if (!defined($baseline));
+
+my $regressions = compareToBaseline($baseline, \@runs);
+print "$0: $regressions regression(s) against $baseline\n";
+exit(($regressions > 0) ? 1 : 0);
+
+sub readSpec
+{
+	my ($file) = @_;
+	open(FILE, "<", $file) or die "$0: Cannot open $file : $!\n";
+	my @benchs;
+	my %seen;
+	while (<FILE>) {
+		chomp;
+		next if (/^ *#/ or /^ *$/);
+		my @temp = split;
+		die "$0: Malformed line $. in $file\n" if (scalar(@temp) < 4);
+		my $name = shift @temp;
+		die "$0: Duplicate benchmark $name in $file\n" if (defined($seen{$name}));
+		$seen{$name} = 1;
+		my $input = shift @temp;
+		my $threads = shift @temp;
+		my @m = split(/,/, shift @temp);
+		die "$0: Threads must be numeric for $name\n" unless ($threads =~ /^\d+$/);
+		push @benchs, {"name" => $name,
+		               "input" => $input,
+		               "threads" => $threads,
+		               "m" => \@m,
+		               "overrides" => \@temp};
+	}
+
+	close(FILE);
+	return @benchs;
+}
+
+# GNU time gives the peak RSS; without it only wall time is recorded
+sub findTime
+{
+	my $t = "/usr/bin/time";
+	return "" unless (-x $t);
+	my $ret = system("$t -f \%M true > /dev/null 2>&1");
+	return ($ret == 0) ? $t : "";
+}
+
+sub prepareDir
+{
+	die "$0: $dmrg not found, build it first\n" unless (-x "$dmrg");
+	die "$0: $toolbox not found, build it first\n" unless (-x "$toolbox");
+	$specDir = abs_path($specDir)."/";
+	$dmrg = abs_path($dmrg);
+	$toolbox = abs_path($toolbox);
+	$baseline = abs_path($baseline) if (defined($baseline));
+
+	my $b = (-r "$workdir");
+	system("mkdir $workdir") if (!$b);
+	chdir("$workdir/") or die "$0: Cannot chdir to $workdir : $!\n";
+}
+
+sub runOne
+{
+	my ($bench, $m) = @_;
+	my $name = $bench->{"name"};
+	my $threads = $bench->{"threads"};
+	my $root = "${name}_m${m}_t$threads";
+	my $input = "$root.inp";
+	createInput($bench, $m, $root, $input);
+
+	print STDERR "$0: Running $root\n";
+	my $cmd = "$dmrg -f $input";
+	$cmd = "$timeCommand -f \"\%e \%M\" -o time_$root.txt $cmd" if ($timeCommand ne "");
+	my $start = time();
+	my $ret = system("$cmd > output_$root.txt 2>&1");
+	my $wall = time() - $start;
+	die "$0: $root failed, see $workdir/output_$root.txt\n" if ($ret != 0);
+
+	my $peakRss;
+	($wall, $peakRss) = readTime("time_$root.txt") if ($timeCommand ne "");
+
+	my %run = ("name" => $name,
+	           "m" => $m,
+	           "threads" => $threads,
+	           "wallSeconds" => $wall,
+	           "peakRssKb" => $peakRss);
+
+	my ($phases, $matvec) = readPhaseTimings($input, $root);
+	$run{"phases"} = $phases;
+	$run{"matvecCalls"} = $matvec->{"calls"};
+	$run{"matvecSeconds"} = $matvec->{"seconds"};
+	my $s = $matvec->{"seconds"};
+	$run{"matvecPerSecond"} = ($s > 0) ? $matvec->{"calls"}/$s : 0;
+	$run{"matvecGflops"} = ($s > 0) ? 1e-9*$matvec->{"flops"}/$s : 0;
+	return \%run;
+}
+
+sub createInput
+{
+	my ($bench, $m, $root, $input) = @_;
+	my $file = $bench->{"input"};
+	$file = "$specDir$file" unless ($file =~ /^\//);
+	open(FILE, "<", $file) or die "$0: Cannot open $file : $!\n";
+	my $data = "";
+	$data .= $_ while (<FILE>);
+	close(FILE);
+
+	my %labels = ("OutputFile" => "$root.txt",
+	              "RandomSeed" => $seed,
+	              "Threads" => $bench->{"threads"});
+	my @options = ("PhaseTimings");
+	push @options, $sOptions if ($sOptions ne "");
+	foreach my $o (@{$bench->{"overrides"}}) {
+		if ($o =~ /^SolverOptions\+=(.+)$/) {
+			push @options, $1;
+		} elsif ($o =~ /^([^=]+)=(.*)$/) {
+			$labels{$1} = $2;
+		} else {
+			die "$0: Override $o of ".$bench->{"name"}." not understood\n";
+		}
+	}
+
+	foreach my $label (sort keys %labels) {
+		my $value = $labels{$label};
+		next if ($data =~ s/^$label=.*$/$label=$value/m);
+		$data .= "\n" unless ($data =~ /\n$/);
+		$data .= "$label=$value\n";
+	}
+
+	my $extra = join(",", @options);
+	$data =~ s/^SolverOptions=(.*)$/SolverOptions=$1,$extra/m
+	or die "$0: No SolverOptions in $file\n";
+	$data =~ s/^SolverOptions=none,/SolverOptions=/m;
+
+	$data = replaceKeptStates($data, $m, $file);
+
+	open(FOUT, ">", $input) or die "$0: Cannot write $input : $!\n";
+	print FOUT $data;
+	close(FOUT);
+}
+
+# Every m of FiniteLoops becomes m; the infinite loop is capped at m
+sub replaceKeptStates
+{
+	my ($data, $m, $file) = @_;
+	$data =~ /FiniteLoops\s+(\d+)\s+/ or die "$0: No FiniteLoops in $file\n";
+	my $n = $1;
+	my $re = "FiniteLoops\\s+\\d+((?:\\s+[+-]?\\d+){".(3*$n)."})";
+	$data =~ /$re/ or die "$0: Malformed FiniteLoops in $file\n";
+	my @loops = split(" ", $1);
+	my $loops = "FiniteLoops $n";
+	for (my $i = 0; $i < $n; ++$i) {
+		$loops .= " ".$loops[3*$i]." $m ".$loops[3*$i + 2];
+	}
+
+	$data =~ s/$re/$loops/;
+
+	if ($data =~ /^InfiniteLoopKeptStates=(\d+)/m) {
+		my $mInf = ($1 < $m) ? $1 : $m;
+		$data =~ s/^InfiniteLoopKeptStates=\d+/InfiniteLoopKeptStates=$mInf/m;
+	}
+
+	return $data;
+}
+
+sub readTime
+{
+	my ($file) = @_;
+	open(FILE, "<", $file) or die "$0: Cannot open $file : $!\n";
+	my ($wall, $rss);
+	while (<FILE>) {
+		($wall, $rss) = ($1, $2) if (/^([\d\.]+) (\d+)$/);
+	}
+
+	close(FILE);
+	defined($rss) or die "$0: Cannot read time and memory from $file\n";
+	return ($wall, $rss);
+}
+
+# Phases are summed over steps; matvec adds all phases ending in matvec
+sub readPhaseTimings
+{
+	my ($input, $root) = @_;
+	my $csv = "phases_$root.csv";
+	my $ret = system("$toolbox -f $input -a phaseTimings > $csv 2> /dev/null");
+	die "$0: $toolbox -a phaseTimings failed for $input\n" if ($ret != 0);
+
+	open(FILE, "<", $csv) or die "$0: Cannot open $csv : $!\n";
+	my %phases;
+	my %matvec = ("calls" => 0, "seconds" => 0, "flops" => 0);
+	while (<FILE>) {
+		chomp;
+		my @temp = split(/,/);
+		next unless (scalar(@temp) == 6 and $temp[0] =~ /^\d+$/);
+		my ($step, $phase, $calls, $seconds, $flops, $bytes) = @temp;
+		$phases{$phase} = {"calls" => 0, "seconds" => 0, "flops" => 0, "bytes" => 0}
+		if (!defined($phases{$phase}));
+		$phases{$phase}->{"calls"} += $calls;
+		$phases{$phase}->{"seconds"} += $seconds;
+		$phases{$phase}->{"flops"} += $flops;
+		$phases{$phase}->{"bytes"} += $bytes;
+		next unless ($phase =~ /(^|\.)matvec$/);
+		$matvec{"calls"} += $calls;
+		$matvec{"seconds"} += $seconds;
+		$matvec{"flops"} += $flops;
+	}
+
+	close(FILE);
+	return (\%phases, \%matvec);
+}
+
+sub writeFile
+{
+	my ($file, $content) = @_;
+	open(FOUT, ">", $file) or die "$0: Cannot write $file : $!\n";
+	print FOUT $content;
+	close(FOUT);
+}
+
+sub writeCsv
+{
+	my ($file, $runs) = @_;
+	my $content = "name,m,threads,metric,value\n";
+	foreach my $run (@$runs) {
+		my $prefix = $run->{"name"}.",".$run->{"m"}.",".$run->{"threads"};
+		foreach my $metric (qw(wallSeconds peakRssKb matvecCalls matvecSeconds
+		                       matvecPerSecond matvecGflops)) {
+			my $value = $run->{$metric};
+			$value = "" if (!defined($value));
+			$content .= "$prefix,$metric,$value\n";
+		}
+
+		my $phases = $run->{"phases"};
+		foreach my $phase (sort keys %$phases) {
+			$content .= "$prefix,seconds:$phase,".$phases->{$phase}->{"seconds"}."\n";
+		}
+	}
+
+	writeFile($file, $content);
+}
+
+# Times and memory must not grow, and throughput must not drop,
+# by more than the tolerance
+sub compareToBaseline
+{
+	my ($file, $runs) = @_;
+	open(FILE, "<", $file) or die "$0: Cannot open $file : $!\n";
+	my $content = "";
+	$content .= $_ while (<FILE>);
+	close(FILE);
+	my $base = JSON::PP->new->decode($content);
+
+	my %baseRuns;
+	foreach my $run (@{$base->{"runs"}}) {
+		$baseRuns{runKey($run)} = $run;
+	}
+
+	my $regressions = 0;
+	foreach my $run (@$runs) {
+		my $key = runKey($run);
+		my $old = $baseRuns{$key};
+		if (!defined($old)) {
+			print "$0: $key not in baseline\n";
+			next;
+		}
+
+		$regressions += compareOne($key, "wallSeconds", $old, $run, 1, $minSeconds);
+		$regressions += compareOne($key, "peakRssKb", $old, $run, 1, 0);
+		$regressions += compareOne($key, "matvecPerSecond", $old, $run, -1, 0);
+		$regressions += compareOne($key, "matvecGflops", $old, $run, -1, 0);
+		my $phases = $run->{"phases"};
+		my $oldPhases = $old->{"phases"};
+		foreach my $phase (sort keys %$phases) {
+			next unless (defined($oldPhases->{$phase}));
+			$regressions += compareOne("$key $phase",
+			                           "seconds",
+			                           $oldPhases->{$phase},
+			                           $phases->{$phase},
+			                           1,
+			                           $minSeconds);
+		}
+	}
+
+	return $regressions;
+}
+
+sub runKey
+{
+	my ($run) = @_;
+	return $run->{"name"}."_m".$run->{"m"}."_t".$run->{"threads"};
+}
+
+# sign is 1 if lower is better and -1 if higher is better
+sub compareOne
+{
+	my ($key, $metric, $old, $new, $sign, $floor) = @_;
+	my $x = $old->{$metric};
+	my $y = $new->{$metric};
+	return 0 if (!defined($x) or !defined($y) or $x == 0);
+	return 0 if ($x < $floor and $y < $floor);
+	my $change = ($y - $x)/$x;
+	return 0 if ($sign*$change <= $tolerance);
+	printf("%s: REGRESSION %s %s %s -> %s (%+.1f%%)\n",
+	       $0, $key, $metric, $x, $y, 100*$change);
+	return 1;
+}
@@ -78,12 +78,13 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 	my @ciAnnotations = Ci::getCiAnnotations("inputs/input$n.inp",$n);
 	my $totalAnnotations = scalar(@ciAnnotations);
 
-	my @postProcessLabels = qw(getTimeObservablesInSitu getEnergyAncilla CollectBrakets metts observe);
+	my @postProcessLabels = qw(getTimeObservablesInSitu getEnergyAncilla CollectBrakets metts observe sameEnergies);
 	my %actions = (getTimeObservablesInSitu => \&checkTimeInSituObs,
 	               getEnergyAncilla => \&checkEnergyAncillaInSitu,
 	               CollectBrakets => \&checkCollectBrakets,
 	               metts => \&checkMetts,
-	               observe => \&checkObserve);
+	               observe => \&checkObserve,
+	               sameEnergies => \&checkSameEnergies);
 	for (my $i = 0; $i < $totalAnnotations; ++$i) {
 		my ($ppLabel, $w) = Ci::readAnnotationFromIndex(\@ciAnnotations, $i);
 		my $x = defined($w) ? scalar(@$w) : 0;
@@ -256,6 +257,42 @@ sub fileSize
 	return $size;
 }
 
+# Test n must give the energies of test m, run in the same workdir
+sub checkSameEnergies
+{
+	my ($n, $what, $workdir, $golddir) = @_;
+	my $whatN = scalar(@$what);
+	my @eN = readGroundStateEnergies($n, $workdir);
+	for (my $i = 0; $i < $whatN; ++$i) {
+		my $m = $what->[$i];
+		my @eM = readGroundStateEnergies($m, $workdir);
+		my $maxEdiff = maxEnergyDiff(\@eN, \@eM);
+		print "|$n|: MaxEnergyDiff with |$m| = $maxEdiff\n";
+	}
+}
+
+sub readGroundStateEnergies
+{
+	my ($n, $dir) = @_;
+	my $file = "$dir/runForinput$n.cout";
+	my @energies;
+	if (!open(FILE, "<", "$file")) {
+		print "|$n|: No $file found\n";
+		return @energies;
+	}
+
+	while (<FILE>) {
+		if (/Ground state energy= ([^ ]+)/) {
+			my $e = $1;
+			chomp($e);
+			push(@energies, $e);
+		}
+	}
+
+	close(FILE);
+	return @energies;
+}
+
 sub checkEnergyAncillaInSitu
 {
 	my ($n, $what, $workdir, $golddir) = @_;
@@ -79,9 +79,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef APPLY_OPERATOR_LOCAL_H
 #define APPLY_OPERATOR_LOCAL_H
 
+#include <algorithm>
 #include "PackIndices.h" // in PsimagLite
 #include "FermionSign.h"
 #include "ProgramGlobals.h"
+#include "TypeToString.h"
 
 namespace Dmrg {
 
@@ -94,6 +96,11 @@ class ApplyOperatorLocal {
 	typedef typename BasisWithOperatorsType::ComplexOrRealType ComplexOrRealType;
 	typedef PsimagLite::PackIndices PackIndicesType;
 	typedef typename BasisWithOperatorsType::OperatorType OperatorType_;
+	typedef typename BasisWithOperatorsType::BasisType BasisType_;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorVectorType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
 
 	class LegacyBug {
 
@@ -135,11 +142,99 @@ class ApplyOperatorLocal {
 		OperatorType_* Aptr_;
 	}; // class LegacyBug
 
+	// The superblock sector of state j, by bisection of the partitions;
+	// consecutive states are mostly in the same sector, so the last one is tried first
+	class SectorOfState {
+
+	public:
+
+		SectorOfState(const BasisType_& super)
+		    : super_(super), last_(0)
+		{}
+
+		SizeType operator()(SizeType j)
+		{
+			if (j >= super_.partition(last_) && j < super_.partition(last_ + 1))
+				return last_;
+
+			SizeType lo = 0;
+			SizeType hi = super_.partition() - 1;
+			while (hi - lo > 1) {
+				SizeType mid = (lo + hi)/2;
+				if (super_.partition(mid) <= j)
+					lo = mid;
+				else
+					hi = mid;
+			}
+
+			assert(j >= super_.partition(lo) && j < super_.partition(lo + 1));
+			last_ = lo;
+			return lo;
+		}
+
+	private:
+
+		const BasisType_& super_;
+		SizeType last_;
+	}; // class SectorOfState
+
+	// Numeric pass: accumulates into the sectors found by the symbolic pass,
+	// slot_[i] being where sector i is kept. Writes to other sectors are
+	// dropped if restricted, that is, if only some sectors were wanted, and
+	// are an error otherwise, since the symbolic pass should have found them
+	class SectorWriter {
+
+	public:
+
+		SectorWriter(const BasisType_& super,
+		             const VectorSizeType& sectors,
+		             bool restricted)
+		    : super_(super),
+		      sectorOf_(super),
+		      restricted_(restricted),
+		      sectors_(sectors),
+		      slot_(super.partition() - 1, sectors.size()),
+		      data_(sectors.size())
+		{
+			for (SizeType ii = 0; ii < sectors_.size(); ++ii) {
+				SizeType i = sectors_[ii];
+				slot_[i] = ii;
+				data_[ii].resize(super_.partition(i + 1) - super_.partition(i), 0.0);
+			}
+		}
+
+		void operator()(SizeType j, const ComplexOrRealType& value)
+		{
+			SizeType i = sectorOf_(j);
+			SizeType ii = slot_[i];
+			if (ii == data_.size()) {
+				if (restricted_) return;
+				err("ApplyOperatorLocal: sector " + ttos(i) + " not found by symbolic pass\n");
+			}
+
+			data_[ii][j - super_.partition(i)] += value;
+		}
+
+		void toVector(VectorWithOffsetType& dest) const
+		{
+			dest.fromSectors(data_, sectors_, super_);
+		}
+
+	private:
+
+		const BasisType_& super_;
+		SectorOfState sectorOf_;
+		bool restricted_;
+		const VectorSizeType& sectors_;
+		VectorSizeType slot_;
+		VectorVectorType data_;
+	}; // class SectorWriter
+
 public:
 
 	enum BorderEnum {BORDER_NO = false, BORDER_YES = true};
 
-	enum {MIDDLE, LEFT_CORNER, RIGHT_CORNER};
+	enum {MIDDLE, LEFT_CORNER, RIGHT_CORNER, HOOK_FOR_ZERO};
 
 	typedef typename BasisWithOperatorsType::BasisType BasisType;
 	typedef VectorWithOffsetType_ VectorWithOffsetType;
@@ -149,8 +244,9 @@ public:
 	    : lrs_(lrs), withLegacyBug_(withLegacyBug)
 	{}
 
-	//! FIXME: we need to make a fast version for when we're just
-	//! figuring out where the (non-zero) partition is
+	// dest is computed without a superblock-sized temporary: a symbolic pass
+	// finds the sectors of dest that can be nonzero, and a numeric pass
+	// accumulates into those sectors only
 	void operator()(VectorWithOffsetType& dest,
 	                const VectorWithOffsetType& src,
 	                const OperatorType& AA,
@@ -160,48 +256,258 @@ public:
 	{
 		LegacyBug legacyBug(withLegacyBug_, AA);
 		const OperatorType& A = legacyBug();
+		apply(dest, src, A, fermionSign, systemOrEnviron, lattice(A, corner), 0);
+	}
 
-		if (corner == BORDER_NO) {
-			if (systemOrEnviron == ProgramGlobals::EXPAND_SYSTEM)
-				applyLocalOpSystem(dest,src,A,fermionSign);
-			else
-				applyLocalOpEnviron(dest,src,A);
-			return;
-		}
-
-		applyLocalOpCorner(dest,src,A,fermionSign);
+	// As above, but only the sectors in wanted of dest are computed; the work
+	// on sectors of src that do not reach them is skipped
+	void operator()(VectorWithOffsetType& dest,
+	                const VectorWithOffsetType& src,
+	                const OperatorType& AA,
+	                const FermionSign& fermionSign,
+	                SizeType systemOrEnviron,
+	                BorderEnum corner,
+	                const VectorSizeType& wanted) const
+	{
+		LegacyBug legacyBug(withLegacyBug_, AA);
+		const OperatorType& A = legacyBug();
+		apply(dest, src, A, fermionSign, systemOrEnviron, lattice(A, corner), &wanted);
 	}
 
-	//! FIXME: we need to make a fast version for when we're just
-	//! figuring out where the (non-zero) partition is
+	// As operator(), with the operator acting on the site of x0
 	void hookForZero(VectorWithOffsetType& dest,
 	                 const VectorWithOffsetType& src,
-	                 const OperatorType& A,
+	                 const OperatorType& AA,
 	                 const FermionSign& fermionSign,
 	                 SizeType systemOrEnviron) const
 	{
 		assert(systemOrEnviron == ProgramGlobals::EXPAND_SYSTEM);
 
-		TargetVectorType dest2(lrs_.super().size(),0.0);
+		LegacyBug legacyBug(withLegacyBug_, AA);
+		const OperatorType& A = legacyBug();
+		apply(dest, src, A, fermionSign, systemOrEnviron, HOOK_FOR_ZERO, 0);
+	}
+
+private:
+
+	ApplyOperatorLocal(const ApplyOperatorLocal&);
+
+	ApplyOperatorLocal& operator=(const ApplyOperatorLocal&);
+
+	// corner cases are all when expanding the system
+	SizeType lattice(const OperatorType& A, BorderEnum corner) const
+	{
+		if (corner == BORDER_NO) return MIDDLE;
+		return (lrs_.right().size() == A.data.rows()) ? RIGHT_CORNER : LEFT_CORNER;
+	}
+
+	void apply(VectorWithOffsetType& dest,
+	           const VectorWithOffsetType& src,
+	           const OperatorType& A,
+	           const FermionSign& fermionSign,
+	           SizeType systemOrEnviron,
+	           SizeType whichPartOfTheLattice,
+	           const VectorSizeType* wanted) const
+	{
+		VectorSizeType srcSectors(src.sectors());
+		for (SizeType ii = 0; ii < src.sectors(); ++ii)
+			srcSectors[ii] = src.sector(ii);
+
+		VectorVectorSizeType images;
+		mapSectors(images, srcSectors, A, systemOrEnviron, whichPartOfTheLattice);
+
+		if (wanted) {
+			VectorBoolType isWanted(lrs_.super().partition() - 1, false);
+			for (SizeType k = 0; k < wanted->size(); ++k)
+				isWanted[(*wanted)[k]] = true;
+
+			for (SizeType ii = 0; ii < images.size(); ++ii) {
+				VectorSizeType& image = images[ii];
+				SizeType k = 0;
+				for (SizeType jj = 0; jj < image.size(); ++jj)
+					if (isWanted[image[jj]]) image[k++] = image[jj];
+				image.resize(k);
+			}
+		}
+
+		VectorSizeType active;
+		for (SizeType ii = 0; ii < images.size(); ++ii)
+			if (images[ii].size() > 0) active.push_back(srcSectors[ii]);
+
+		VectorSizeType sectors;
+		unionOf(sectors, images);
+
+		SectorWriter writer(lrs_.super(), sectors, (wanted != 0));
+		applyLocalOp(writer, src, active, A, fermionSign, systemOrEnviron, whichPartOfTheLattice);
+		writer.toVector(dest);
+	}
+
+	template<typename SinkType>
+	void applyLocalOp(SinkType& sink,
+	                  const VectorWithOffsetType& src,
+	                  const VectorSizeType& srcSectors,
+	                  const OperatorType& A,
+	                  const FermionSign& fermionSign,
+	                  SizeType systemOrEnviron,
+	                  SizeType whichPartOfTheLattice) const
+	{
+		for (SizeType ii=0;ii<srcSectors.size();ii++) {
+			SizeType i = srcSectors[ii];
+			switch (whichPartOfTheLattice) {
+			case MIDDLE:
+				if (systemOrEnviron == ProgramGlobals::EXPAND_SYSTEM)
+					applyLocalOpSystem(sink,src,A,fermionSign,i);
+				else
+					applyLocalOpEnviron(sink,src,A,i);
+				break;
+			case LEFT_CORNER:
+				applyLocalOpLeftCorner(sink,src,A,i);
+				break;
+			case RIGHT_CORNER:
+				applyLocalOpRightCorner(sink,src,A,i);
+				break;
+			case HOOK_FOR_ZERO:
+				hookForZeroSystem(sink,src,A,fermionSign,i);
+				break;
+			}
+		}
+	}
+
+	// Symbolic pass: images[ii] has the sectors of the superblock, sorted, that
+	// A maps sector srcSectors[ii] to. A acts on one side, left or right, and
+	// maps each block of a left partition times a right partition to the
+	// blocks given by partitionImages; a block is in one sector, found from
+	// its first state
+	void mapSectors(VectorVectorSizeType& images,
+	                const VectorSizeType& srcSectors,
+	                const OperatorType& A,
+	                SizeType systemOrEnviron,
+	                SizeType whichPartOfTheLattice) const
+	{
+		const BasisType& left = lrs_.left();
+		const BasisType& right = lrs_.right();
+		const BasisType& super = lrs_.super();
+
+		bool leftSide = true;
+		VectorVectorSizeType next;
+		partitionImages(next, leftSide, A, systemOrEnviron, whichPartOfTheLattice);
+
+		VectorSizeType leftPartition;
+		VectorSizeType rightPartition;
+		partitionOfStates(leftPartition, left);
+		partitionOfStates(rightPartition, right);
+
+		SizeType ns = left.size();
+		SizeType npl = left.partition() - 1;
+		VectorSizeType blockMark(npl*(right.partition() - 1), 0);
+		VectorSizeType sectorMark(super.partition() - 1, 0);
+		SectorOfState sectorOf(super);
+		images.resize(srcSectors.size());
+		for (SizeType ii = 0; ii < srcSectors.size(); ++ii) {
+			SizeType s = srcSectors[ii];
+			VectorSizeType& image = images[ii];
+			image.clear();
+			for (SizeType i = super.partition(s); i < super.partition(s + 1); ++i) {
+				SizeType r = super.permutation(i);
+				SizeType pl = leftPartition[r % ns];
+				SizeType pr = rightPartition[r / ns];
+				SizeType block = pl + pr*npl;
+				if (blockMark[block] == ii + 1) continue;
+				blockMark[block] = ii + 1;
+
+				const VectorSizeType& targets = next[(leftSide) ? pl : pr];
+				for (SizeType t = 0; t < targets.size(); ++t) {
+					SizeType x = left.partition((leftSide) ? targets[t] : pl);
+					SizeType y = right.partition((leftSide) ? pr : targets[t]);
+					SizeType q = sectorOf(super.permutationInverse(x + y*ns));
+					if (sectorMark[q] == ii + 1) continue;
+					sectorMark[q] = ii + 1;
+					image.push_back(q);
+				}
+			}
+
+			std::sort(image.begin(), image.end());
+		}
+	}
 
-		for (SizeType ii = 0; ii < src.sectors(); ++ii) {
-			SizeType i = src.sector(ii);
-			hookForZeroSystem(dest2,src,A,fermionSign,i);
+	// next[p] has the partitions that A maps the states of partition p to,
+	// on the side that A acts on, left if leftSide; as the kernels below
+	void partitionImages(VectorVectorSizeType& next,
+	                     bool& leftSide,
+	                     const OperatorType& A,
+	                     SizeType systemOrEnviron,
+	                     SizeType whichPartOfTheLattice) const
+	{
+		leftSide = (whichPartOfTheLattice != RIGHT_CORNER);
+		if (whichPartOfTheLattice == MIDDLE)
+			leftSide = (systemOrEnviron == ProgramGlobals::EXPAND_SYSTEM);
+
+		const BasisType& basis = (leftSide) ? lrs_.left() : lrs_.right();
+		SizeType rows = A.data.rows();
+		SizeType nx = (whichPartOfTheLattice == MIDDLE && !leftSide) ? rows
+		                                                            : basis.size()/rows;
+		PackIndicesType pack(nx);
+		VectorSizeType partitionOf;
+		partitionOfStates(partitionOf, basis);
+
+		SizeType np = basis.partition() - 1;
+		next.assign(np, VectorSizeType());
+		VectorSizeType mark(np, 0);
+		for (SizeType p = 0; p < np; ++p) {
+			for (SizeType x = basis.partition(p); x < basis.partition(p + 1); ++x) {
+				SizeType x0 = 0;
+				SizeType x1 = 0;
+				SizeType row = x;
+				if (whichPartOfTheLattice == MIDDLE || whichPartOfTheLattice == HOOK_FOR_ZERO) {
+					pack.unpack(x0, x1, basis.permutation(x));
+					row = (whichPartOfTheLattice == MIDDLE && leftSide) ? x1 : x0;
+				}
+
+				for (int k = A.data.getRowPtr(row); k < A.data.getRowPtr(row + 1); ++k) {
+					SizeType col = A.data.getCol(k);
+					SizeType xprime = col;
+					if (whichPartOfTheLattice == MIDDLE && leftSide)
+						xprime = basis.permutationInverse(x0 + col*nx);
+					else if (whichPartOfTheLattice == MIDDLE ||
+					         whichPartOfTheLattice == HOOK_FOR_ZERO)
+						xprime = basis.permutationInverse(col + x1*nx);
+
+					SizeType q = partitionOf[xprime];
+					if (mark[q] == p + 1) continue;
+					mark[q] = p + 1;
+					next[p].push_back(q);
+				}
+			}
 		}
+	}
+
+	static void partitionOfStates(VectorSizeType& p, const BasisType& basis)
+	{
+		p.resize(basis.size());
+		SizeType np = basis.partition() - 1;
+		for (SizeType i = 0; i < np; ++i)
+			for (SizeType j = basis.partition(i); j < basis.partition(i + 1); ++j)
+				p[j] = i;
+	}
 
-		dest.fromFull(dest2,lrs_.super());
+	static void unionOf(VectorSizeType& dest, const VectorVectorSizeType& images)
+	{
+		dest.clear();
+		for (SizeType ii = 0; ii < images.size(); ++ii)
+			dest.insert(dest.end(), images[ii].begin(), images[ii].end());
+
+		std::sort(dest.begin(), dest.end());
+		dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void hookForZeroSystem(TargetVectorType& dest2,
+	// sink(j, value) for each term of transpose(A) * src; corrected if !withLegacyBug
+	template<typename SinkType>
+	void hookForZeroSystem(SinkType& sink,
 	                       const VectorWithOffsetType& src,
-	                       const OperatorType& AA,
+	                       const OperatorType& A,
 	                       const FermionSign&,
 	                       SizeType i0) const
 	{
-		LegacyBug legacyBug(withLegacyBug_, AA);
-		const OperatorType& A = legacyBug();
-
 		SizeType offset = src.offset(i0);
 		SizeType final = offset + src.effectiveSize(i0);
 		SizeType ns = lrs_.left().permutationVector().size();
@@ -227,44 +533,14 @@ public:
 				SizeType x0prime = A.data.getCol(k);
 				SizeType xprime = lrs_.left().permutationInverse(x0prime+x1*nx);
 				SizeType j = lrs_.super().permutationInverse(xprime+y*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k);
-			}
-		}
-	}
-
-private:
-
-	ApplyOperatorLocal(const ApplyOperatorLocal&);
-
-	ApplyOperatorLocal& operator=(const ApplyOperatorLocal&);
-
-	void applyLocalOpSystem(VectorWithOffsetType& dest,
-	                        const VectorWithOffsetType& src,
-	                        const OperatorType& A,
-	                        const FermionSign& fermionSign,
-	                        SizeType whichPartOfTheLattice = MIDDLE) const
-	{
-		TargetVectorType dest2(lrs_.super().size(),0.0);
-
-		for (SizeType ii=0;ii<src.sectors();ii++) {
-			SizeType i = src.sector(ii);
-			switch (whichPartOfTheLattice) {
-			case MIDDLE:
-				applyLocalOpSystem(dest2,src,A,fermionSign,i);
-				break;
-			case LEFT_CORNER:
-				throw PsimagLite::RuntimeError("applyLocalOpSystem: internal error\n");
-			case RIGHT_CORNER:
-				applyLocalOpRightCorner(dest2,src,A,i);
-				break;
+				sink(j, src.slowAccess(i)*A.data.getValue(k));
 			}
 		}
-
-		dest.fromFull(dest2,lrs_.super());
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpSystem(TargetVectorType& dest2,
+	// sink(j, value) for each term of transpose(A) * src; corrected if !withLegacyBug
+	template<typename SinkType>
+	void applyLocalOpSystem(SinkType& sink,
 	                        const VectorWithOffsetType& src,
 	                        const OperatorType& A,
 	                        const FermionSign& fermionSign,
@@ -296,37 +572,14 @@ private:
 				SizeType x1prime = A.data.getCol(k);
 				SizeType xprime = lrs_.left().permutationInverse(x0+x1prime*nx);
 				SizeType j = lrs_.super().permutationInverse(xprime+y*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
-			}
-		}
-	}
-
-	void applyLocalOpEnviron(VectorWithOffsetType& dest,
-	                         const VectorWithOffsetType& src,
-	                         const OperatorType& A,
-	                         SizeType whichPartOfTheLattice = MIDDLE) const
-	{
-		TargetVectorType dest2(lrs_.super().size(),0.0);
-
-		for (SizeType ii=0;ii<src.sectors();ii++) {
-			SizeType i = src.sector(ii);
-			switch (whichPartOfTheLattice) {
-			case MIDDLE:
-				applyLocalOpEnviron(dest2,src,A,i);
-				break;
-			case LEFT_CORNER:
-				applyLocalOpLeftCorner(dest2,src,A,i);
-				break;
-			case RIGHT_CORNER:
-				err("applyLocalOpEnviron: internal error\n");
+				sink(j, src.slowAccess(i)*A.data.getValue(k)*sign);
 			}
 		}
-
-		dest.fromFull(dest2,lrs_.super());
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpEnviron(TargetVectorType& dest2,
+	// sink(j, value) for each term of transpose(A) * src; corrected if !withLegacyBug
+	template<typename SinkType>
+	void applyLocalOpEnviron(SinkType& sink,
 	                         const VectorWithOffsetType& src,
 	                         const OperatorType& A,
 	                         SizeType i0) const
@@ -353,13 +606,14 @@ private:
 				SizeType y0prime = A.data.getCol(k);
 				SizeType yprime = lrs_.right().permutationInverse(y0prime+y1*nx);
 				SizeType j = lrs_.super().permutationInverse(x+yprime*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
+				sink(j, src.slowAccess(i)*A.data.getValue(k)*sign);
 			}
 		}
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpLeftCorner(TargetVectorType& dest2,
+	// sink(j, value) for each term of transpose(A) * src; corrected if !withLegacyBug
+	template<typename SinkType>
+	void applyLocalOpLeftCorner(SinkType& sink,
 	                            const VectorWithOffsetType& src,
 	                            const OperatorType& A,
 	                            SizeType i0) const
@@ -380,13 +634,14 @@ private:
 			for (SizeType k = start; k < end; ++k) {
 				SizeType xprime = A.data.getCol(k);
 				SizeType j = lrs_.super().permutationInverse(xprime+y*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k);
+				sink(j, src.slowAccess(i)*A.data.getValue(k));
 			}
 		}
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpRightCorner(TargetVectorType& dest2,
+	// sink(j, value) for each term of transpose(A) * src; corrected if !withLegacyBug
+	template<typename SinkType>
+	void applyLocalOpRightCorner(SinkType& sink,
 	                             const VectorWithOffsetType& src,
 	                             const OperatorType& A,
 	                             SizeType i0) const
@@ -412,25 +667,11 @@ private:
 			for (SizeType k = start; k < end; ++k) {
 				SizeType yprime = A.data.getCol(k);
 				SizeType j = lrs_.super().permutationInverse(x+yprime*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
+				sink(j, src.slowAccess(i)*A.data.getValue(k)*sign);
 			}
 		}
 	}
 
-	// entry point for corner cases. These are all when expanding ths system
-	void applyLocalOpCorner(VectorWithOffsetType& dest,
-	                        const VectorWithOffsetType& src,
-	                        const OperatorType& A,
-	                        const FermionSign& fermionSign) const
-	{
-		if (lrs_.right().size() == A.data.rows()) { // right corner
-			applyLocalOpSystem(dest,src,A,fermionSign,RIGHT_CORNER);
-			return;
-		}
-
-		applyLocalOpEnviron(dest,src,A,LEFT_CORNER);
-	}
-
 	const LeftRightSuperType& lrs_;
 	bool withLegacyBug_;
 }; // class ApplyOperatorLocal
@@ -0,0 +1,276 @@
+#ifndef BLOCK_DAVIDSON_SOLVER_H
+#define BLOCK_DAVIDSON_SOLVER_H
+#include <algorithm>
+#include <cmath>
+#include "Vector.h"
+#include "Matrix.h"
+#include "Random48.h"
+#include "ProgressIndicator.h"
+
+namespace Dmrg {
+
+/* Lowest nev eigenpairs of a Hermitian matrix together, by block Davidson
+
+   The subspace starts from the guess and the next nev-1 vectors of its
+   Krylov space, and grows with the corrections of the Ritz pairs not yet
+   converged, (theta - D)^{-1} r for Ritz value theta and residual r, where D
+   is the diagonal of the matrix, given by its diagonal(). The residuals of
+   all nev pairs are recomputed every iteration, and only those above
+   params.tolerance give corrections, so a pair that converged and drifts
+   after a restart is corrected again. When the subspace would exceed
+   maxBasis vectors it is restarted thick, with up to 2*nev of the lowest
+   Ritz vectors, and H times them, so that the restart needs no products;
+   at least one correction always fits after a restart.
+   Stops when all nev residuals are below params.tolerance, after
+   params.steps iterations, or, with a warning, when no correction
+   enlarges the subspace.
+*/
+template<typename ParametersType, typename MatrixType, typename VectorType>
+class BlockDavidsonSolver {
+
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> DenseMatrixType;
+
+public:
+
+	BlockDavidsonSolver(const MatrixType& mat,
+	                    const ParametersType& params,
+	                    SizeType nev,
+	                    int long seed)
+	    : mat_(mat),
+	      params_(params),
+	      nev_(nev),
+	      maxBasis_(std::max(4*nev, static_cast<SizeType>(20))),
+	      rng_(seed),
+	      progress_("BlockDavidson")
+	{
+		assert(nev_ > 0);
+	}
+
+	// The excited-th level, with a random guess
+	void computeExcitedState(RealType& energy, VectorType& z, SizeType excited)
+	{
+		VectorType initial(mat_.rows());
+		randomVector(initial);
+		computeExcitedState(energy, z, initial, excited);
+	}
+
+	// The excited-th level; all nev levels are in eigenvalue() and eigenvector()
+	void computeExcitedState(RealType& energy,
+	                         VectorType& z,
+	                         const VectorType& initial,
+	                         SizeType excited)
+	{
+		if (excited >= nev_)
+			err("BlockDavidsonSolver: excited must be smaller than levels\n");
+
+		solve(initial);
+		energy = eigs_[excited];
+		z = vectors_[excited];
+	}
+
+	const RealType& eigenvalue(SizeType i) const { return eigs_[i]; }
+
+	const VectorType& eigenvector(SizeType i) const { return vectors_[i]; }
+
+private:
+
+	void solve(const VectorType& initial)
+	{
+		SizeType n = mat_.rows();
+		if (nev_ > n)
+			err("BlockDavidsonSolver: more levels than rows\n");
+
+		SizeType maxBasis = std::min(maxBasis_, n);
+		mat_.diagonal(diag_);
+		assert(diag_.size() == n);
+		VectorVectorType v;
+		VectorVectorType w;
+		VectorType x = initial;
+		for (SizeType i = 0; i < nev_; ++i) {
+			if (i > 0) x = w[i - 1];
+			while (!addToBasis(v, w, x))
+				randomVector(x);
+		}
+
+		SizeType iter = 0;
+		SizeType converged = 0;
+		for (; iter < params_.steps; ++iter) {
+			SizeType m = v.size();
+			DenseMatrixType s(m, m);
+			for (SizeType i = 0; i < m; ++i)
+				for (SizeType j = i; j < m; ++j) {
+					s(i, j) = dot(v[i], w[j]);
+					s(j, i) = PsimagLite::conj(s(i, j));
+				}
+
+			VectorRealType theta(m);
+			diag(s, theta, 'V');
+
+			VectorVectorType corrections;
+			converged = ritz(corrections, v, w, s, theta);
+			if (converged == nev_) break;
+
+			if (m + corrections.size() > maxBasis) {
+				SizeType wanted = std::min(corrections.size(), maxBasis - nev_);
+				SizeType keep = std::max(nev_, std::min(2*nev_, maxBasis - wanted));
+				restart(v, w, s, std::min(m, keep));
+			}
+
+			SizeType added = 0;
+			for (SizeType k = 0; k < corrections.size(); ++k) {
+				if (v.size() == maxBasis) break;
+				if (addToBasis(v, w, corrections[k])) ++added;
+			}
+
+			if (added > 0) continue;
+
+			std::cerr<<"WARNING: BlockDavidsonSolver: no correction enlarges ";
+			std::cerr<<"the subspace of "<<v.size()<<" vectors (maxBasis="<<maxBasis;
+			std::cerr<<"), stopping with "<<converged<<" of "<<nev_<<" levels converged\n";
+			break;
+		}
+
+		if (converged < nev_ && iter == params_.steps)
+			std::cerr<<"WARNING: BlockDavidsonSolver: only "<<converged<<" of "
+			        <<nev_<<" levels converged after "<<iter<<" iterations\n";
+
+		PsimagLite::OstringStream msg;
+		msg<<"Levels="<<nev_<<" converged="<<converged<<" iterations="<<iter;
+		msg<<" lowest="<<eigs_[0]<<" highest="<<eigs_[nev_ - 1];
+		progress_.printline(msg, std::cout);
+	}
+
+	// Sets eigs_ and vectors_ to the lowest Ritz pairs, adds the corrections
+	// of those whose residuals are not small, and returns how many are small
+	SizeType ritz(VectorVectorType& corrections,
+	              const VectorVectorType& v,
+	              const VectorVectorType& w,
+	              const DenseMatrixType& s,
+	              const VectorRealType& theta)
+	{
+		SizeType n = mat_.rows();
+		SizeType m = v.size();
+		eigs_.resize(nev_);
+		vectors_.resize(nev_);
+		SizeType converged = 0;
+		for (SizeType k = 0; k < nev_; ++k) {
+			VectorType& xk = vectors_[k];
+			VectorType r(n, 0.0);
+			xk.resize(n);
+			std::fill(xk.begin(), xk.end(), 0.0);
+			for (SizeType i = 0; i < m; ++i) {
+				ComplexOrRealType c = s(i, k);
+				for (SizeType j = 0; j < n; ++j) {
+					xk[j] += c*v[i][j];
+					r[j] += c*w[i][j];
+				}
+			}
+
+			eigs_[k] = theta[k];
+			for (SizeType j = 0; j < n; ++j)
+				r[j] -= theta[k]*xk[j];
+
+			if (PsimagLite::norm(r) < params_.tolerance) {
+				++converged;
+				continue;
+			}
+
+			precondition(r, theta[k]);
+			corrections.push_back(r);
+		}
+
+		return converged;
+	}
+
+	// r = (theta - D)^{-1} r, with the denominators kept away from zero
+	void precondition(VectorType& r, RealType theta) const
+	{
+		const RealType minDenominator = 1e-4;
+		for (SizeType j = 0; j < r.size(); ++j) {
+			RealType denominator = theta - PsimagLite::real(diag_[j]);
+			if (fabs(denominator) < minDenominator)
+				denominator = (denominator < 0) ? -minDenominator : minDenominator;
+			r[j] /= denominator;
+		}
+	}
+
+	// v and w become the first keep Ritz vectors and H times them
+	static void restart(VectorVectorType& v,
+	                    VectorVectorType& w,
+	                    const DenseMatrixType& s,
+	                    SizeType keep)
+	{
+		SizeType m = v.size();
+		SizeType n = v[0].size();
+		VectorVectorType v2(keep, VectorType(n, 0.0));
+		VectorVectorType w2(keep, VectorType(n, 0.0));
+		for (SizeType k = 0; k < keep; ++k) {
+			for (SizeType i = 0; i < m; ++i) {
+				ComplexOrRealType c = s(i, k);
+				for (SizeType j = 0; j < n; ++j) {
+					v2[k][j] += c*v[i][j];
+					w2[k][j] += c*w[i][j];
+				}
+			}
+		}
+
+		v.swap(v2);
+		w.swap(w2);
+	}
+
+	// Orthonormalizes x against v, twice, and if it is not in their span adds it
+	// to v and H x to w
+	bool addToBasis(VectorVectorType& v, VectorVectorType& w, VectorType& x) const
+	{
+		RealType norma0 = PsimagLite::norm(x);
+		if (norma0 == 0) return false;
+
+		for (SizeType pass = 0; pass < 2; ++pass) {
+			for (SizeType i = 0; i < v.size(); ++i) {
+				ComplexOrRealType c = dot(v[i], x);
+				for (SizeType j = 0; j < x.size(); ++j)
+					x[j] -= c*v[i][j];
+			}
+		}
+
+		RealType norma = PsimagLite::norm(x);
+		if (norma < 1e-10*norma0) return false;
+
+		x /= norma;
+		v.push_back(x);
+		w.push_back(VectorType(x.size(), 0.0));
+		mat_.matrixVectorProduct(w.back(), x);
+		return true;
+	}
+
+	void randomVector(VectorType& x)
+	{
+		for (SizeType j = 0; j < x.size(); ++j)
+			x[j] = rng_() - 0.5;
+	}
+
+	static ComplexOrRealType dot(const VectorType& a, const VectorType& b)
+	{
+		ComplexOrRealType sum = 0.0;
+		for (SizeType j = 0; j < a.size(); ++j)
+			sum += PsimagLite::conj(a[j])*b[j];
+		return sum;
+	}
+
+	const MatrixType& mat_;
+	const ParametersType& params_;
+	SizeType nev_;
+	SizeType maxBasis_;
+	PsimagLite::Random48<RealType> rng_;
+	PsimagLite::ProgressIndicator progress_;
+	VectorType diag_;
+	VectorRealType eigs_;
+	VectorVectorType vectors_;
+}; // class BlockDavidsonSolver
+} // namespace Dmrg
+
+#endif // BLOCK_DAVIDSON_SOLVER_H
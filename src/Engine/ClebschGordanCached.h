@@ -74,12 +74,18 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 /*! \file ClebschGordanCached.h
  *
+ *  Table of all Clebsch-Gordan coefficients with j1, j2 < jmax
  *
- *
+ *  The table is built by init(), before any SU(2) code runs, and is
+ *  read-only afterwards, so that all threads share it without locks.
+ *  Coefficients are stored by (j1,m1), (j2,m2) and then j, with j fastest;
+ *  given j1, j2, m1 and m2 only j = |j1-j2|, |j1-j2|+2, ..., j1+j2
+ *  (in units of 1/2) can be nonzero, so only those are stored.
  */
 #ifndef CLEBSCH_GORDANCACHED_H
 #define CLEBSCH_GORDANCACHED_H
 
+#include <cassert>
 #include "ClebschGordan.h"
 #include "ProgressIndicator.h"
 
@@ -93,61 +99,75 @@ class ClebschGordanCached {
 public:
 
 	ClebschGordanCached(SizeType jmax)
-	    :  UNDEFINED_VALUE(-1000),
-	      jmax_(jmax),
-	      max2_(((jmax_-1)*(jmax_+2))/2+1),max22_(max2_*max2_),
-	      data_(max22_*jmax_*2,UNDEFINED_VALUE),cgObject_(2)
+	    : jmax_(0),
+	      max2_(0),
+	      cgObject_(2)
 	{
 		init(jmax,2);
 	}
 
 	void init(SizeType jmax,SizeType nfactorials)
 	{
+		// (j1+j2+j)/2+1 is the largest factorial needed
+		if (nfactorials < 2*jmax) nfactorials = 2*jmax;
+
 		jmax_=jmax;
-		max2_=((jmax_-1)*(jmax_+2))/2+1;
-		max22_=max2_*max2_;
-		data_.resize(max22_*jmax_*2,UNDEFINED_VALUE);
+		max2_=(jmax_*(jmax_+1))/2;
 		cgObject_.init(nfactorials);
-
-		copies_++;
-		if (copies_>2) {
-			std::cerr<<"WARNING: ClebschGordanCached has ";
-			std::cerr<<copies_<<" copies.\n";
-		}
+		build();
 	}
 
-	FieldType operator()(const PairType& jm,const PairType& jm1,const PairType& jm2)
+	// receiving format is (2*j,j+m)
+	FieldType operator()(const PairType& jm,const PairType& jm1,const PairType& jm2) const
 	{
 		if (!checkCg(jm,jm1,jm2)) return 0;
 
-		SizeType index1 = calcSubIndex(jm1);
-		SizeType index2 = calcSubIndex(jm2);
-		SizeType jmin=0;
-		if (jm1.first>jm2.first) jmin = jm1.first-jm2.first;
-		else jmin = jm2.first-jm1.first;
-		SizeType x = calcIndex(index1,index2)+(jm.first-jmin)*max22_;
-		if (data_[x]== UNDEFINED_VALUE) {
-			data_[x]=cgObject_(jm,jm1,jm2);
-		}
+		SizeType jmin = (jm1.first>jm2.first) ? jm1.first-jm2.first : jm2.first-jm1.first;
+		assert(jm.first >= jmin && (jm.first - jmin)%2 == 0);
+		SizeType x = calcIndex(calcSubIndex(jm1),calcSubIndex(jm2))*jmax_ +
+		        (jm.first-jmin)/2;
+		assert(x < data_.size());
 		return data_[x];
 	}
 
 private:
+
+	void build()
+	{
+		data_.assign(max2_*max2_*jmax_, 0);
+		for (SizeType j1 = 0; j1 < jmax_; ++j1) {
+			for (SizeType m1 = 0; m1 <= j1; ++m1) {
+				PairType jm1(j1,m1);
+				SizeType index1 = calcSubIndex(jm1);
+				for (SizeType j2 = 0; j2 < jmax_; ++j2) {
+					SizeType jmin = (j1>j2) ? j1-j2 : j2-j1;
+					for (SizeType m2 = 0; m2 <= j2; ++m2) {
+						PairType jm2(j2,m2);
+						SizeType offset = calcIndex(index1,calcSubIndex(jm2))*jmax_;
+						for (SizeType j = jmin; j <= j1 + j2; j += 2) {
+							int m = calcM(j,jm1,jm2);
+							if (m<0 || SizeType(m)>j) continue;
+							PairType jm(j,m);
+							data_[offset + (j-jmin)/2] = cgObject_(jm,jm1,jm2);
+						}
+					}
+				}
+			}
+		}
+	}
+
 	SizeType calcSubIndex(const PairType& jm) const
 	{
-		if (jm.second==0) return jm.first;
-		SizeType x = 2*jmax_-1-jm.second;
-		x *= jm.second;
-		x /= 2;
-		x += jm.first;
-		if (x>=max2_)
-			throw PsimagLite::RuntimeError("problem calcSubIndex\n");
+		if (jm.first>=jmax_)
+			throw PsimagLite::RuntimeError("ClebschGordanCached: j too large\n");
+		SizeType x = (jm.first*(jm.first+1))/2 + jm.second;
+		assert(x<max2_);
 		return x;
 	}
 
 	SizeType calcIndex(SizeType i1,SizeType i2) const
 	{
-		if (i1>=max2_ || i2>=max2_) throw PsimagLite::RuntimeError("problem\n");
+		assert(i1<max2_ && i2<max2_);
 		return i1+i2*max2_;
 	}
 
@@ -181,17 +201,11 @@ private:
 		return jm1.second+jm2.second-x;
 	}
 
-	static SizeType copies_;
-	int UNDEFINED_VALUE;
 	SizeType jmax_;
-	SizeType max2_,max22_;
+	SizeType max2_;
 	typename PsimagLite::Vector<FieldType>::Type data_;
 	ClebschGordanType cgObject_;
 }; // class ClebschGordanCached
-
-template<typename FieldType>
-SizeType ClebschGordanCached<FieldType>::copies_=0;
-
 } // namespace Dmrg
 /*@}*/
 #endif
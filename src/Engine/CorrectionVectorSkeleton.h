@@ -298,8 +298,17 @@ public:
 		VectorWithOffsetType tv4;
 		VectorWithOffsetType tv5;
 		calcDynVectors(tv1,tv4,tv5);
-		tv2 += (-1.0)*tv5;
-		tv3 += tv4;
+
+		typename VectorWithOffsetType::VectorConstPointerType vs(2);
+		typename VectorWithOffsetType::VectorType c(2, 1.0);
+		vs[0] = &tv2;
+		vs[1] = &tv5;
+		c[1] = -1.0;
+		VectorWithOffsetType::linearCombination(tv2, c, vs);
+		vs[0] = &tv3;
+		vs[1] = &tv4;
+		c[1] = 1.0;
+		VectorWithOffsetType::linearCombination(tv3, c, vs);
 	}
 
 	template<typename SomeTargetingCommonType>
@@ -85,6 +85,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "CrsMatrix.h"
 #include "ApplyOperatorLocal.h"
 #include "Braket.h"
+#include "DenseBlockBracket.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
 #include <numeric>
 
 namespace Dmrg {
@@ -129,6 +132,9 @@ public:
 	typedef typename VectorType::value_type FieldType;
 	typedef typename BasisWithOperatorsType::OperatorType OperatorType;
 	typedef PsimagLite::CrsMatrix<FieldType> SparseMatrixType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef DenseBlockBracket<BasisType, VectorWithOffsetType, SparseMatrixType>
+	DenseBlockBracketType;
 
 	enum {GROW_RIGHT,GROW_LEFT};
 
@@ -165,10 +171,11 @@ public:
 		int nt=i-1;
 		if (nt<0) nt=0;
 
+		// Onew keeps its storage from one site to the next
+		SparseMatrixType Onew;
 		for (SizeType s=nt;s<ns;s++) {
 			helper_.setPointer(threadId,s);
 			SizeType growOption = growthDirection(s,nt,i,threadId);
-			SparseMatrixType Onew(helper_.cols(threadId),helper_.cols(threadId));
 
 			fluffUp(Onew,Odest,fermionicSign,growOption,false,threadId);
 			if (!transform && s == ns-1) {
@@ -180,6 +187,25 @@ public:
 		}
 	}
 
+	// Step s of growDirectly(..., transform = true, ...),
+	// so that an operator can be grown one site at a time
+	void growStep(SparseMatrixType& O,
+	              SizeType i,
+	              int fermionicSign,
+	              SizeType s,
+	              SizeType threadId)
+	{
+		int nt=i-1;
+		if (nt<0) nt=0;
+
+		helper_.setPointer(threadId,s);
+		SizeType growOption = growthDirection(s,nt,i,threadId);
+		SparseMatrixType Onew;
+
+		fluffUp(Onew,O,fermionicSign,growOption,false,threadId);
+		helper_.transform(O,Onew,threadId);
+	}
+
 	SizeType growthDirection(SizeType s,int nt,SizeType i,SizeType threadId) const
 	{
 		SizeType dir = helper_.direction(threadId);
@@ -200,79 +226,14 @@ public:
 	             bool transform,
 	             SizeType threadId)
 	{
-		ProgramGlobals::DirectionEnum dir = helper_.direction(threadId);
-
-		const BasisType& basis = (dir == EXPAND_SYSTEM) ? helper_.leftRightSuper(threadId).left() :
-		                                                  helper_.leftRightSuper(threadId).right();
-
-		SizeType n = basis.size();
-		SizeType orows = O.rows();
-		SizeType ktotal = n/orows;
-		SparseMatrixType ret(n, n, ktotal*O.nonZeros());
-
-		if (growOption==GROW_RIGHT) {
-			RealType sign = (dir == ProgramGlobals::EXPAND_ENVIRON)
-			        ? fermionSignBasis(fermionicSign, helper_.leftRightSuper(threadId).left()) :
-			          1;
-
-			SizeType counter = 0;
-			for (SizeType k = 0; k < ktotal; ++k) {
-				for (SizeType i = 0; i < orows; ++i) {
-					ret.setRow(i + k*orows, counter);
-					for (int kj = O.getRowPtr(i); kj < O.getRowPtr(i + 1); ++kj) {
-						// Sperm[e0] = i + k*n
-						// Sperm[e1] = j + k*n
-
-						SizeType col = basis.
-						        permutationInverse(O.getCol(kj) + k*orows);
-
-						ret.setCol(counter, col);
-						ret.setValues(counter++, O.getValue(kj)*sign);
-					}
-				}
-			}
-
-			ret.setRow(n, counter);
-			ret.checkValidity();
-		} else {
-
-			SizeType counter = 0;
-			for (SizeType i = 0; i < orows; ++i) {
-				for (SizeType k = 0; k < ktotal; ++k) {
-					ret.setRow(k + i*ktotal, counter);
-					RealType sign = 1;
-					if (dir == ProgramGlobals::EXPAND_ENVIRON) {
-						sign = (fermionicSign > 0) ? 1 : fermionSignBasis(fermionicSign,
-						                        helper_.leftRightSuper(threadId).left())*
-						        helper_.signsOneSite(k);
-					} else {
-						sign = helper_.fermionicSignLeft(threadId)(k, fermionicSign);
-					}
-
-					for (int kj = O.getRowPtr(i); kj < O.getRowPtr(i + 1); ++kj) {
-						// Sperm[e0] = k + i*m
-						// Sperm[e1] = k + j*m
-
-						SizeType col = basis.
-						        permutationInverse(k + O.getCol(kj)*ktotal);
-
-						ret.setCol(counter, col);
-						ret.setValues(counter++, O.getValue(kj)*sign);
-					}
-				}
-			}
-
-			ret.setRow(n, counter);
-			ret.checkValidity();
-		}
-
-		reorderRowsCrs(ret, basis);
 		if (transform) {
+			SparseMatrixType ret;
+			growAndReorder(ret, O, fermionicSign, growOption, threadId);
 			helper_.transform(ret2, ret, threadId);
 			return;
 		}
 
-		ret2 = ret;
+		growAndReorder(ret2, O, fermionicSign, growOption, threadId);
 	}
 
 	void dmrgMultiply(SparseMatrixType& result,
@@ -355,6 +316,10 @@ public:
 
 private:
 
+	// Brackets go to DenseBlockBracket when the blocks of a left times a right
+	// partition have, on average, this many states or more
+	static const SizeType denseBlockMinimum_ = 256;
+
 	int fermionSignBasis(int fermionicSign, const BasisType& basis) const
 	{
 		const typename BasisWithOperatorsType::VectorBoolType& v = basis.signs();
@@ -480,27 +445,69 @@ private:
 		result.checkValidity();
 	}
 
-	static void reorderRowsCrs(SparseMatrixType& matrix, const BasisType& basis)
+	// O grown by one site, written directly with the rows in the order of the
+	// basis: row r of ret is row basis.permutation(r) of the grown operator,
+	// and has the nonzeros of the row of O that it comes from.
+	// ret is resized in place, so that its storage is reused when a caller
+	// grows into the same matrix site after site
+	void growAndReorder(SparseMatrixType& ret,
+	                    const SparseMatrixType& O,
+	                    int fermionicSign,
+	                    int growOption,
+	                    SizeType threadId)
 	{
-		SizeType nrows = matrix.rows();
-		SizeType ncols = matrix.cols();
-		SparseMatrixType matrix2(nrows, ncols, matrix.nonZeros());
+		ProgramGlobals::DirectionEnum dir = helper_.direction(threadId);
+
+		const BasisType& basis = (dir == EXPAND_SYSTEM) ? helper_.leftRightSuper(threadId).left() :
+		                                                  helper_.leftRightSuper(threadId).right();
+
+		SizeType n = basis.size();
+		SizeType orows = O.rows();
+		SizeType ktotal = n/orows;
+		ret.resize(n, n, ktotal*O.nonZeros());
+
+		bool growRight = (growOption == GROW_RIGHT);
+		RealType signRight = 1;
+		if (growRight && dir == ProgramGlobals::EXPAND_ENVIRON)
+			signRight = fermionSignBasis(fermionicSign, helper_.leftRightSuper(threadId).left());
 
 		SizeType counter = 0;
-		for (SizeType row = 0; row < nrows; ++row) {
-			matrix2.setRow(row, counter);
+		for (SizeType row = 0; row < n; ++row) {
+			ret.setRow(row, counter);
 			SizeType r = basis.permutation(row);
-			SizeType start = matrix.getRowPtr(r);
-			SizeType end = matrix.getRowPtr(r + 1);
-			for (SizeType k = start; k < end; ++k) {
-				matrix2.setCol(counter, matrix.getCol(k));
-				matrix2.setValues(counter++, matrix.getValue(k));
+			SizeType i = 0;
+			SizeType k = 0;
+			RealType sign = signRight;
+			if (growRight) {
+				// Sperm[e0] = i + k*n
+				// Sperm[e1] = j + k*n
+				i = r % orows;
+				k = r / orows;
+			} else {
+				// Sperm[e0] = k + i*m
+				// Sperm[e1] = k + j*m
+				k = r % ktotal;
+				i = r / ktotal;
+				if (dir == ProgramGlobals::EXPAND_ENVIRON) {
+					sign = (fermionicSign > 0) ? 1 : fermionSignBasis(fermionicSign,
+					                        helper_.leftRightSuper(threadId).left())*
+					        helper_.signsOneSite(k);
+				} else {
+					sign = helper_.fermionicSignLeft(threadId)(k, fermionicSign);
+				}
+			}
+
+			for (int kj = O.getRowPtr(i); kj < O.getRowPtr(i + 1); ++kj) {
+				SizeType j = O.getCol(kj);
+				SizeType col = (growRight) ? basis.permutationInverse(j + k*orows) :
+				                             basis.permutationInverse(k + j*ktotal);
+				ret.setCol(counter, col);
+				ret.setValues(counter++, O.getValue(kj)*sign);
 			}
 		}
 
-		matrix2.setRow(nrows, counter);
-		matrix2.checkValidity();
-		matrix = matrix2;
+		ret.setRow(n, counter);
+		ret.checkValidity();
 	}
 
 	FieldType bracket_(const SparseMatrixType& A,
@@ -528,6 +535,11 @@ private:
 	                         const VectorWithOffsetType& vec2,
 	                         SizeType threadId)
 	{
+		if (denseBlocks(threadId)) {
+			VectorRealType noSigns;
+			return denseBracket(vec1,vec2,&A,0,noSigns,noSigns,threadId);
+		}
+
 		FieldType sum=0;
 		PackIndicesType pack(helper_.leftRightSuper(threadId).left().size());
 		for (SizeType x=0;x<vec1.sectors();x++) {
@@ -562,6 +574,11 @@ private:
 		RealType sign = fermionSignBasis(fermionicSign,
 		                                 helper_.leftRightSuper(threadId).left());
 
+		if (denseBlocks(threadId)) {
+			VectorRealType noSigns;
+			return denseBracket(vec1,vec2,0,&A,noSigns,noSigns,threadId)*sign;
+		}
+
 		FieldType sum=0;
 		PackIndicesType pack(helper_.leftRightSuper(threadId).left().size());
 		SizeType leftSize = helper_.leftRightSuper(threadId).left().size();
@@ -634,6 +651,17 @@ private:
 		if (ni != Acrs.rows())
 			err("Observe::brRghtCrnrSystem_(...)\n");
 
+		if (denseBlocks(threadId)) {
+			const BasisType& left = helper_.leftRightSuper(threadId).left();
+			SparseMatrixType leftOp;
+			embedOperator(leftOp,&Acrs,0,false,ni,left);
+			VectorRealType signLeft(left.size());
+			for (SizeType r = 0; r < signLeft.size(); ++r)
+				signLeft[r] = left.fermionicSign(r,fermionSign);
+			VectorRealType noSigns;
+			return denseBracket(vec1,vec2,&leftOp,&Bcrs,signLeft,noSigns,threadId);
+		}
+
 		// ok, we're ready for the main course:
 		PackIndicesType pack1(helper_.leftRightSuper(threadId).left().size());
 		PackIndicesType pack2(ni);
@@ -697,6 +725,24 @@ private:
 		if (helper_.leftRightSuper(threadId).right().size()/Bcrs.rows() != Acrs.rows())
 			err("Observe::brLftCrnrEnviron_(...)\n");
 
+		if (denseBlocks(threadId)) {
+			const BasisType& right = helper_.leftRightSuper(threadId).right();
+			SparseMatrixType rightOp;
+			embedOperator(rightOp,0,&Acrs,true,ni,right);
+			VectorRealType signsRight(right.size(),1.0);
+			PackIndicesType pack(ni);
+			for (SizeType r = 0; r < signsRight.size(); ++r) {
+				if (fermionSign > 0) continue;
+				SizeType r0 = 0;
+				SizeType r1 = 0;
+				pack.unpack(r0,r1,right.permutation(r));
+				signsRight[r] = helper_.signsOneSite(r0)*signRight;
+			}
+
+			VectorRealType noSigns;
+			return denseBracket(vec1,vec2,&Bcrs,&rightOp,noSigns,signsRight,threadId);
+		}
+
 		// ok, we're ready for the main course:
 		PackIndicesType pack1(helper_.leftRightSuper(threadId).left().size());
 		PackIndicesType pack2(ni);
@@ -764,6 +810,24 @@ private:
 		assert(ni==A1crs.rows());
 		assert(Bcrs.rows()==A2crs.rows());
 
+		if (denseBlocks(threadId)) {
+			const BasisType& left = helper_.leftRightSuper(threadId).left();
+			const BasisType& right = helper_.leftRightSuper(threadId).right();
+			SparseMatrixType leftOp;
+			embedOperator(leftOp,&A1crs,&A2crs,false,ni,left);
+			VectorRealType signLeft(left.size());
+			PackIndicesType pack(ni);
+			for (SizeType r = 0; r < signLeft.size(); ++r) {
+				SizeType r0 = 0;
+				SizeType r1 = 0;
+				pack.unpack(r0,r1,left.permutation(r));
+				signLeft[r] = right.fermionicSign(r1,fermionSign);
+			}
+
+			VectorRealType noSigns;
+			return denseBracket(vec1,vec2,&leftOp,&Bcrs,signLeft,noSigns,threadId);
+		}
+
 		// ok, we're ready for the main course:
 		PackIndicesType pack1(helper_.leftRightSuper(threadId).left().size());
 		PackIndicesType pack2(ni);
@@ -809,6 +873,80 @@ private:
 		return resultDivided(sum,vec1);
 	}
 
+	bool denseBlocks(SizeType threadId) const
+	{
+		const BasisType& left = helper_.leftRightSuper(threadId).left();
+		const BasisType& right = helper_.leftRightSuper(threadId).right();
+		SizeType blocks = (left.partition() - 1)*(right.partition() - 1);
+		return (left.size()*right.size() >= denseBlockMinimum_*blocks);
+	}
+
+	// <vec1|L x R|vec2> with signs, see DenseBlockBracket, threaded over sectors
+	FieldType denseBracket(const VectorWithOffsetType& vec1,
+	                       const VectorWithOffsetType& vec2,
+	                       const SparseMatrixType* L,
+	                       const SparseMatrixType* R,
+	                       const VectorRealType& signLeft,
+	                       const VectorRealType& signRight,
+	                       SizeType threadId)
+	{
+		DenseBlockBracketType helper(helper_.leftRightSuper(threadId).left(),
+		                             helper_.leftRightSuper(threadId).right(),
+		                             helper_.leftRightSuper(threadId).super(),
+		                             vec1,
+		                             vec2,
+		                             L,
+		                             R,
+		                             signLeft,
+		                             signRight);
+
+		typedef PsimagLite::Parallelizer<DenseBlockBracketType> ParallelizerType;
+		ParallelizerType threadedSectors(PsimagLite::Concurrency::codeSectionParams);
+		threadedSectors.loopCreate(helper);
+
+		return resultDivided(helper.sum(),vec1);
+	}
+
+	// The operator A0 x A1 of basis, where state r is r0 + r1*ni before the
+	// permutation; a null factor is the identity
+	static void embedOperator(SparseMatrixType& result,
+	                          const SparseMatrixType* A0,
+	                          const SparseMatrixType* A1,
+	                          bool conjugate,
+	                          SizeType ni,
+	                          const BasisType& basis)
+	{
+		SizeType n = basis.size();
+		result.resize(n,n);
+		PackIndicesType pack(ni);
+
+		SizeType counter = 0;
+		for (SizeType r = 0; r < n; ++r) {
+			result.setRow(r,counter);
+			SizeType r0 = 0;
+			SizeType r1 = 0;
+			pack.unpack(r0,r1,basis.permutation(r));
+			int start0 = (A0) ? A0->getRowPtr(r0) : 0;
+			int end0 = (A0) ? A0->getRowPtr(r0 + 1) : 1;
+			int start1 = (A1) ? A1->getRowPtr(r1) : 0;
+			int end1 = (A1) ? A1->getRowPtr(r1 + 1) : 1;
+			for (int k0 = start0; k0 < end0; ++k0) {
+				SizeType c0 = (A0) ? A0->getCol(k0) : r0;
+				FieldType v0 = (A0) ? A0->getValue(k0) : 1.0;
+				for (int k1 = start1; k1 < end1; ++k1) {
+					SizeType c1 = (A1) ? A1->getCol(k1) : r1;
+					FieldType v = v0*((A1) ? A1->getValue(k1) : 1.0);
+					result.pushCol(basis.permutationInverse(c0 + c1*ni));
+					result.pushValue((conjugate) ? PsimagLite::conj(v) : v);
+					++counter;
+				}
+			}
+		}
+
+		result.setRow(n,counter);
+		result.checkValidity();
+	}
+
 	FieldType resultDivided(FieldType sum, const VectorWithOffsetType& vec) const
 	{
 		FieldType tmp = vec*vec;
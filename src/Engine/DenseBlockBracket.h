@@ -0,0 +1,263 @@
+#ifndef DENSE_BLOCK_BRACKET_H
+#define DENSE_BLOCK_BRACKET_H
+#include <map>
+#include <algorithm>
+#include "Vector.h"
+
+namespace Dmrg {
+
+/* <vec1|L x R|vec2> with vec1 and vec2 as dense blocks
+
+   sum_{t,t2} conj(vec1[t]) sL(l) sR(e) L(l,l2) R(e,e2) vec2[t2],
+   where superblock state t is left state l and right state e, and t2 is
+   l2 and e2 in the same sector as t. L and R are operators of the left
+   and right basis, or the identity if null; sL and sR are signs of the
+   left and right states, or one if empty.
+   A superblock sector is made of whole blocks of a left partition times
+   a right partition, so each block of each vector is kept as a dense
+   matrix Psi(l,e), row major, and the sum is
+   Tr(Psi1^dagger S L Psi2 R^T) over the pairs of blocks of a sector, done
+   as two sparse-dense products: T = L Psi2, with rows of Psi2 added to
+   rows of T, and then the rows of R against T.
+   One task per sector of vec1, with its value in value(); sum() adds them.
+*/
+template<typename BasisType, typename VectorWithOffsetType, typename SparseMatrixType>
+class DenseBlockBracket {
+
+	typedef typename VectorWithOffsetType::value_type FieldType;
+	typedef typename PsimagLite::Real<FieldType>::Type RealType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef std::pair<SizeType, SizeType> PairSizeType;
+
+	struct Block {
+
+		Block(SizeType pl_, SizeType pr_, const BasisType& left, const BasisType& right)
+		    : pl(pl_),
+		      pr(pr_),
+		      lStart(left.partition(pl_)),
+		      lSize(left.partition(pl_ + 1) - lStart),
+		      eStart(right.partition(pr_)),
+		      eSize(right.partition(pr_ + 1) - eStart),
+		      psi1(lSize*eSize, 0.0),
+		      psi2(lSize*eSize, 0.0)
+		{}
+
+		SizeType pl;
+		SizeType pr;
+		SizeType lStart;
+		SizeType lSize;
+		SizeType eStart;
+		SizeType eSize;
+		VectorType psi1;
+		VectorType psi2;
+	}; // struct Block
+
+	typedef typename PsimagLite::Vector<Block>::Type VectorBlockType;
+
+public:
+
+	DenseBlockBracket(const BasisType& left,
+	                  const BasisType& right,
+	                  const BasisType& super,
+	                  const VectorWithOffsetType& vec1,
+	                  const VectorWithOffsetType& vec2,
+	                  const SparseMatrixType* L,
+	                  const SparseMatrixType* R,
+	                  const VectorRealType& signLeft,
+	                  const VectorRealType& signRight)
+	    : left_(left),
+	      right_(right),
+	      super_(super),
+	      vec1_(vec1),
+	      vec2_(vec2),
+	      L_(L),
+	      R_(R),
+	      signLeft_(signLeft),
+	      signRight_(signRight),
+	      leftPartition_(left.size()),
+	      rightPartition_(right.size()),
+	      values_(vec1.sectors(), 0.0)
+	{
+		assert(!L_ || L_->rows() == left_.size());
+		assert(!R_ || R_->rows() == right_.size());
+		assert(signLeft_.size() == 0 || signLeft_.size() == left_.size());
+		assert(signRight_.size() == 0 || signRight_.size() == right_.size());
+
+		findPartitions(leftPartition_, left_);
+		findPartitions(rightPartition_, right_);
+	}
+
+	SizeType tasks() const { return values_.size(); }
+
+	void doTask(SizeType taskNumber, SizeType)
+	{
+		SizeType sector = vec1_.sector(taskNumber);
+		SizeType offset = vec1_.offset(sector);
+		SizeType total = vec1_.effectiveSize(sector);
+		if (vec2_.offset(sector) != offset || vec2_.effectiveSize(sector) != total)
+			return;
+
+		VectorBlockType blocks;
+		fillBlocks(blocks, offset, offset + total);
+
+		FieldType sum = 0.0;
+		VectorType t;
+		for (SizeType b1 = 0; b1 < blocks.size(); ++b1) {
+			for (SizeType b2 = 0; b2 < blocks.size(); ++b2) {
+				const Block& block1 = blocks[b1];
+				const Block& block2 = blocks[b2];
+				if (!L_ && block1.pl != block2.pl) continue;
+				if (!R_ && block1.pr != block2.pr) continue;
+
+				const VectorType* lpsi2 = &block2.psi2;
+				if (L_) {
+					if (!leftProduct(t, block1, block2)) continue;
+					lpsi2 = &t;
+				}
+
+				sum += rightProduct(block1, block2, *lpsi2);
+			}
+		}
+
+		values_[taskNumber] = sum;
+	}
+
+	const FieldType& value(SizeType taskNumber) const { return values_[taskNumber]; }
+
+	FieldType sum() const
+	{
+		FieldType s = 0.0;
+		for (SizeType i = 0; i < values_.size(); ++i)
+			s += values_[i];
+		return s;
+	}
+
+private:
+
+	static void findPartitions(VectorSizeType& p, const BasisType& basis)
+	{
+		SizeType np = basis.partition() - 1;
+		for (SizeType i = 0; i < np; ++i)
+			for (SizeType j = basis.partition(i); j < basis.partition(i + 1); ++j)
+				p[j] = i;
+	}
+
+	// The blocks of the states [offset, total) of the superblock, with the
+	// values of vec1 and vec2 in them
+	void fillBlocks(VectorBlockType& blocks, SizeType offset, SizeType total) const
+	{
+		SizeType leftSize = left_.size();
+		std::map<PairSizeType, SizeType> indexOfBlock;
+		SizeType last = 0;
+		for (SizeType t = offset; t < total; ++t) {
+			SizeType p = super_.permutation(t);
+			SizeType l = p % leftSize;
+			SizeType e = p / leftSize;
+			PairSizeType key(leftPartition_[l], rightPartition_[e]);
+			if (blocks.size() == 0 || blocks[last].pl != key.first ||
+			        blocks[last].pr != key.second) {
+				typename std::map<PairSizeType, SizeType>::const_iterator it =
+				        indexOfBlock.find(key);
+				if (it == indexOfBlock.end()) {
+					last = blocks.size();
+					indexOfBlock[key] = last;
+					blocks.push_back(Block(key.first, key.second, left_, right_));
+				} else {
+					last = it->second;
+				}
+			}
+
+			Block& block = blocks[last];
+			SizeType index = (e - block.eStart) + (l - block.lStart)*block.eSize;
+			block.psi1[index] = vec1_.slowAccess(t);
+			block.psi2[index] = vec2_.slowAccess(t);
+		}
+	}
+
+	// t = L(block1 rows, block2 rows) * psi2 of block2, with the rows of block1
+	// and the columns of block2; false if that part of L is zero
+	bool leftProduct(VectorType& t, const Block& block1, const Block& block2) const
+	{
+		SizeType cols = block2.eSize;
+		t.resize(block1.lSize*cols);
+		std::fill(t.begin(), t.end(), 0.0);
+		bool nonZero = false;
+		for (SizeType i = 0; i < block1.lSize; ++i) {
+			SizeType l = block1.lStart + i;
+			FieldType* ti = &(t[i*cols]);
+			for (int k = L_->getRowPtr(l); k < L_->getRowPtr(l + 1); ++k) {
+				SizeType l2 = L_->getCol(k);
+				if (l2 < block2.lStart || l2 >= block2.lStart + block2.lSize) continue;
+				nonZero = true;
+				const FieldType value = L_->getValue(k);
+				const FieldType* psi2 = &(block2.psi2[(l2 - block2.lStart)*cols]);
+				for (SizeType j = 0; j < cols; ++j)
+					ti[j] += value*psi2[j];
+			}
+		}
+
+		return nonZero;
+	}
+
+	// sum over the states of block1 of conj(psi1) sL sR (lpsi2 R^T), where lpsi2
+	// has the rows of block1 and the columns of block2
+	FieldType rightProduct(const Block& block1,
+	                       const Block& block2,
+	                       const VectorType& lpsi2) const
+	{
+		SizeType cols = block2.eSize;
+		VectorSizeType rcol;
+		VectorType rvalue;
+		FieldType sum = 0.0;
+		for (SizeType j = 0; j < block1.eSize; ++j) {
+			SizeType e = block1.eStart + j;
+			rcol.clear();
+			rvalue.clear();
+			if (R_) {
+				for (int k = R_->getRowPtr(e); k < R_->getRowPtr(e + 1); ++k) {
+					SizeType e2 = R_->getCol(k);
+					if (e2 < block2.eStart || e2 >= block2.eStart + cols) continue;
+					rcol.push_back(e2 - block2.eStart);
+					rvalue.push_back(R_->getValue(k));
+				}
+
+				if (rcol.size() == 0) continue;
+			} else {
+				rcol.push_back(j);
+				rvalue.push_back(1.0);
+			}
+
+			RealType sR = (signRight_.size() == 0) ? 1.0 : signRight_[e];
+			for (SizeType i = 0; i < block1.lSize; ++i) {
+				const FieldType* lpsi2i = &(lpsi2[i*cols]);
+				FieldType u = 0.0;
+				for (SizeType k = 0; k < rcol.size(); ++k)
+					u += rvalue[k]*lpsi2i[rcol[k]];
+
+				RealType sL = (signLeft_.size() == 0) ? 1.0 :
+				                                       signLeft_[block1.lStart + i];
+				sum += PsimagLite::conj(block1.psi1[j + i*block1.eSize])*u*sL*sR;
+			}
+		}
+
+		return sum;
+	}
+
+	const BasisType& left_;
+	const BasisType& right_;
+	const BasisType& super_;
+	const VectorWithOffsetType& vec1_;
+	const VectorWithOffsetType& vec2_;
+	const SparseMatrixType* L_;
+	const SparseMatrixType* R_;
+	const VectorRealType& signLeft_;
+	const VectorRealType& signRight_;
+	VectorSizeType leftPartition_;
+	VectorSizeType rightPartition_;
+	VectorType values_;
+}; // class DenseBlockBracket
+} // namespace Dmrg
+
+#endif // DENSE_BLOCK_BRACKET_H
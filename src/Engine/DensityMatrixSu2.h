@@ -85,6 +85,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "DensityMatrixBase.h"
 #include "ProgramGlobals.h"
 #include "DiagBlockDiagMatrix.h"
+#include "BLAS.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
 
 namespace Dmrg {
 template<typename TargetingType>
@@ -101,6 +104,48 @@ class DensityMatrixSu2 : public DensityMatrixBase<TargetingType> {
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef typename DensityMatrixBase<TargetingType>::Params ParamsType;
 	typedef typename BasisType::BlockType VectorSizeType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+	/* One task per partition m of pBasis, that assembles the block m of the
+	   density matrix. Partitions have very different sizes, so the
+	   Parallelizer weights are not used and the blocks go to threads as they
+	   become free.
+	*/
+	class ParallelBlocks {
+
+	public:
+
+		ParallelBlocks(DensityMatrixSu2& dm,
+		               const TargetingType& target,
+		               const BasisWithOperatorsType& pBasisSummed,
+		               const BasisType& pSE,
+		               ProgramGlobals::DirectionEnum direction)
+		    : dm_(dm),
+		      target_(target),
+		      pBasisSummed_(pBasisSummed),
+		      pSE_(pSE),
+		      direction_(direction)
+		{}
+
+		SizeType tasks() const { return dm_.pBasis_.partition() - 1; }
+
+		void doTask(SizeType m, SizeType)
+		{
+			BuildingBlockType matrixBlock;
+			dm_.densityMatrixBlock(matrixBlock, m, target_, pBasisSummed_, pSE_, direction_);
+			dm_.data_.setBlock(m, dm_.pBasis_.partition(m), matrixBlock);
+		}
+
+	private:
+
+		DensityMatrixSu2& dm_;
+		const TargetingType& target_;
+		const BasisWithOperatorsType& pBasisSummed_;
+		const BasisType& pSE_;
+		ProgramGlobals::DirectionEnum direction_;
+	}; // class ParallelBlocks
+
+	friend class ParallelBlocks;
 
 public:
 
@@ -116,7 +161,6 @@ public:
 	      debug_(p.debug)
 	{
 		check();
-		BuildingBlockType matrixBlock;
 
 		const BasisWithOperatorsType& pBasisSummed =
 		        (p.direction == ProgramGlobals::EXPAND_SYSTEM) ? lrs.right() :
@@ -131,23 +175,13 @@ public:
 				//if (enforceSymmetry && SizeType(m)!=mMaximal_[m]) continue;
 				// we'll fill non-maximal partitions later
 			}
-
-			SizeType bs = pBasis_.partition(m+1)-pBasis_.partition(m);
-
-			matrixBlock.resize(bs, bs, static_cast<ComplexOrRealType>(0.0));
-
-			for (SizeType i=pBasis_.partition(m);i<pBasis_.partition(m+1);i++) {
-				for (SizeType j=pBasis_.partition(m);j<pBasis_.partition(m+1);j++) {
-
-					matrixBlock(i-pBasis_.partition(m),j-pBasis_.partition(m))=
-					        densityMatrixAux(i,j,target,pBasisSummed,lrs.super(),p.direction);
-
-				}
-			}
-
-			data_.setBlock(m,pBasis_.partition(m),matrixBlock);
 		}
 
+		typedef PsimagLite::Parallelizer<ParallelBlocks> ParallelizerType;
+		ParallelizerType threadedBlocks(PsimagLite::Concurrency::codeSectionParams);
+		ParallelBlocks helper(*this, target, pBasisSummed, lrs.super(), p.direction);
+		threadedBlocks.loopCreate(helper);
+
 		if (debug_) areAllMsEqual(pBasis_);
 	}
 
@@ -244,44 +278,74 @@ private:
 		return true;
 	}
 
-	ComplexOrRealType densityMatrixAux(SizeType alpha1,
-	                                          SizeType alpha2,
-	                                          const TargetingType& target,
-	                                          const BasisWithOperatorsType& pBasisSummed,
-	                                          const BasisType& pSE,
-	                                          ProgramGlobals::DirectionEnum direction)
+	// Block m of the density matrix, sum over targets of weight W W^dagger,
+	// where W(alpha, beta) is the wave-function of the target with alpha in
+	// partition m of pBasis and beta in pBasisSummed, in the product basis
+	// given by the factors of pSE. W is kept with its nonzero columns only.
+	void densityMatrixBlock(BuildingBlockType& matrixBlock,
+	                        SizeType m,
+	                        const TargetingType& target,
+	                        const BasisWithOperatorsType& pBasisSummed,
+	                        const BasisType& pSE,
+	                        ProgramGlobals::DirectionEnum direction) const
 	{
-		ComplexOrRealType sum=0;
+		SizeType bs = pBasis_.partition(m+1)-pBasis_.partition(m);
+		matrixBlock.resize(bs, bs, static_cast<ComplexOrRealType>(0.0));
+		if (bs == 0) return;
+
 		// The g.s. has to be treated separately because it's
 		// usually a vector of RealType, whereas
-		// the other targets might be complex,
-		// and C++ generic programming capabilities are weak... we need D!!!
-		if (target.includeGroundStage())
-			sum +=  densityMatrixHasFactors(alpha1,
-			                                alpha2,
-			                                target.gs(),
-			                                pBasisSummed,
-			                                pSE,
-			                                direction)*target.gsWeight();
-
-		for (SizeType i = 0; i < target.size(); ++i)
-			sum += densityMatrixHasFactors(alpha1,
-			                               alpha2,
-			                               target(i),
-			                               pBasisSummed,
-			                               pSE,
-			                               direction)*target.weight(i)/target.normSquared(i);
-
-		return sum;
+		// the other targets might be complex
+		MatrixType w;
+		if (target.includeGroundStage() && target.gsWeight() != 0) {
+			reducedWaveFunction(w,m,target.gs(),pBasisSummed,pSE,direction);
+			addProduct(matrixBlock,w,target.gsWeight());
+		}
+
+		for (SizeType i = 0; i < target.size(); ++i) {
+			RealType weight = target.weight(i);
+			if (weight == 0) continue;
+			reducedWaveFunction(w,m,target(i),pBasisSummed,pSE,direction);
+			addProduct(matrixBlock,w,weight/target.normSquared(i));
+		}
 	}
 
+	// matrixBlock += weight w w^dagger
+	static void addProduct(BuildingBlockType& matrixBlock,
+	                       const MatrixType& w,
+	                       RealType weight)
+	{
+		SizeType bs = w.rows();
+		SizeType cols = w.cols();
+		if (cols == 0) return;
+
+		ComplexOrRealType alpha = weight;
+		ComplexOrRealType beta = 1.0;
+		psimag::BLAS::GEMM('N',
+		                   'C',
+		                   bs,
+		                   bs,
+		                   cols,
+		                   alpha,
+		                   &(w(0,0)),
+		                   bs,
+		                   &(w(0,0)),
+		                   bs,
+		                   beta,
+		                   &(matrixBlock(0,0)),
+		                   bs);
+	}
+
+	// w(alpha - partition(m), c) = sum_k factors(i, k) v[permutationInverse(k)],
+	// with i the product state of alpha and beta, for the c-th beta that gives
+	// a nonzero column
 	template<typename TargetVectorType>
-	ComplexOrRealType densityMatrixHasFactors(SizeType alpha1,
-	                                                 SizeType alpha2,
-	                                                 const TargetVectorType& v,
-	                                                 const BasisWithOperatorsType& pBasisSummed,
-	                                                 const BasisType& pSE,
-	                                                 ProgramGlobals::DirectionEnum direction)
+	void reducedWaveFunction(MatrixType& w,
+	                         SizeType m,
+	                         const TargetVectorType& v,
+	                         const BasisWithOperatorsType& pBasisSummed,
+	                         const BasisType& pSE,
+	                         ProgramGlobals::DirectionEnum direction) const
 	{
 		int ne = pBasisSummed.size();
 		int ns = pSE.size()/ne;
@@ -291,37 +355,45 @@ private:
 			ne=pSE.size()/ns;
 		}
 
-		ComplexOrRealType sum=0;
-
 		// Make sure we don't copy just get the reference here!!
 		const FactorsType* fptr = pSE.getFactors();
 		assert(fptr);
 		const FactorsType& factors = *fptr;
 
+		SizeType start = pBasis_.partition(m);
+		SizeType bs = pBasis_.partition(m+1) - start;
+		typename PsimagLite::Vector<ComplexOrRealType>::Type column(bs);
+		typename PsimagLite::Vector<ComplexOrRealType>::Type nonZero;
+		SizeType cols = 0;
 		for (SizeType beta=0;beta<total;beta++) {
-			// sum over environ:
-			int i1 = alpha1+beta*ns;
-			int i2 = alpha2+beta*ns;
-			// sum over system:
-			if (direction != ProgramGlobals::EXPAND_SYSTEM) {
-				i1 = beta + alpha1*ns;
-				i2 = beta + alpha2*ns;
-			}
-			for (int k1=factors.getRowPtr(i1);k1<factors.getRowPtr(i1+1);k1++) {
-				int eta1 = factors.getCol(k1);
-				int ii = pSE.permutationInverse(eta1);
-				for (int k2=factors.getRowPtr(i2);k2<factors.getRowPtr(i2+1);k2++) {
-					int eta2 =  factors.getCol(k2);
-					int jj = pSE.permutationInverse(eta2);
-
-					ComplexOrRealType tmp3= v.slowAccess(ii)*
-					        PsimagLite::conj(v.slowAccess(jj)) *
-					        factors.getValue(k1) * factors.getValue(k2);
-					sum += tmp3;
+			bool isZero = true;
+			for (SizeType a=0;a<bs;a++) {
+				SizeType alpha = a + start;
+				// sum over environ:
+				int i1 = alpha+beta*ns;
+				// sum over system:
+				if (direction != ProgramGlobals::EXPAND_SYSTEM)
+					i1 = beta + alpha*ns;
+
+				ComplexOrRealType sum = 0.0;
+				for (int k1=factors.getRowPtr(i1);k1<factors.getRowPtr(i1+1);k1++) {
+					int ii = pSE.permutationInverse(factors.getCol(k1));
+					sum += v.slowAccess(ii)*factors.getValue(k1);
 				}
+
+				column[a] = sum;
+				if (sum != static_cast<ComplexOrRealType>(0.0)) isZero = false;
 			}
+
+			if (isZero) continue;
+			nonZero.insert(nonZero.end(), column.begin(), column.end());
+			++cols;
 		}
-		return sum;
+
+		w.resize(bs, cols, static_cast<ComplexOrRealType>(0.0));
+		for (SizeType c = 0; c < cols; ++c)
+			for (SizeType a = 0; a < bs; ++a)
+				w(a, c) = nonZero[a + c*bs];
 	}
 
 	//! only used for debugging
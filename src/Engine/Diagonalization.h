@@ -83,8 +83,10 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "LanczosSolver.h"
 #include "DavidsonSolver.h"
+#include "BlockDavidsonSolver.h"
 #include "ParametersForSolver.h"
 #include "Concurrency.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
@@ -126,6 +128,9 @@ public:
 	typedef PsimagLite::LanczosSolver<ParametersForSolverType,
 	MatrixVectorType,
 	TargetVectorType> LanczosSolverType;
+	typedef BlockDavidsonSolver<ParametersForSolverType,
+	MatrixVectorType,
+	TargetVectorType> BlockDavidsonSolverType;
 
 	Diagonalization(const ParametersType& parameters,
 	                const ModelType& model,
@@ -143,7 +148,8 @@ public:
 	      progress_("Diag."),
 	      quantumSector_(quantumSector),
 	      wft_(waveFunctionTransformation),
-	      oldEnergy_(oldEnergy)
+	      oldEnergy_(oldEnergy),
+	      matvecs_(0)
 	{}
 
 	//!PTEX_LABEL{Diagonalization}
@@ -157,8 +163,9 @@ public:
 		VectorSizeType sectors;
 		targetedSymmetrySectors(sectors,target.lrs());
 		reflectionOperator_.update(sectors);
-		RealType gsEnergy = internalMain_(target,direction,loopIndex,false,blockLeft);
+		RealType gsEnergy = internalMain_(target,direction,loopIndex,0.0,blockLeft);
 		//  targeting:
+		Instrumentation::Timer timer("targeting");
 		target.evolve(gsEnergy,direction,blockLeft,blockRight,loopIndex);
 		wft_.triggerOff(target.lrs());
 		return gsEnergy;
@@ -168,12 +175,14 @@ public:
 	                    ProgramGlobals::DirectionEnum direction,
 	                    const BlockType& block,
 	                    SizeType loopIndex,
+	                    RealType truncationError,
 	                    bool)
 	{
 		assert(direction != ProgramGlobals::INFINITE);
 
-		RealType gsEnergy = internalMain_(target,direction,loopIndex,false,block);
+		RealType gsEnergy = internalMain_(target,direction,loopIndex,truncationError,block);
 		//  targeting:
+		Instrumentation::Timer timer("targeting");
 		target.evolve(gsEnergy,direction,block,block,loopIndex);
 		wft_.triggerOff(target.lrs());
 		return gsEnergy;
@@ -194,10 +203,11 @@ private:
 	RealType internalMain_(TargetingType& target,
 	                       ProgramGlobals::DirectionEnum direction,
 	                       SizeType loopIndex,
-	                       bool,
+	                       RealType truncationError,
 	                       const VectorSizeType& block)
 
 	{
+		Instrumentation::Timer timer("diagonalization");
 		PsimagLite::String options = parameters_.options;
 		bool findSymmetrySector = (options.find("findSymmetrySector") != PsimagLite::String::npos);
 		const LeftRightSuperType& lrs= target.lrs();
@@ -251,7 +261,14 @@ private:
 		SizeType totalSectors = sectors.size();
 		VectorWithOffsetType initialVector(weights, lrs.super());
 
-		target.initialGuess(initialVector, block, noguess);
+		ParametersForSolverType params(io_,"Lanczos");
+		adaptSolverParams(params, direction, loopIndex, truncationError);
+		matvecs_ = 0;
+
+		{
+			Instrumentation::Timer timer("wft");
+			target.initialGuess(initialVector, block, noguess);
+		}
 
 		typename PsimagLite::Vector<RealType>::Type energySaved(totalSectors);
 		typename PsimagLite::Vector<TargetVectorType>::Type vecSaved(totalSectors);
@@ -295,12 +312,17 @@ private:
 				                    lrs,
 				                    target.time(),
 				                    initialVectorBySector,
-				                    saveOption);
+				                    saveOption,
+				                    params);
 			}
 
 			energySaved[j] = gsEnergy;
 		}
 
+		PsimagLite::OstringStream msgMatvecs;
+		msgMatvecs<<"Matrix-vector products of the eigensolver= "<<matvecs_;
+		progress_.printline(msgMatvecs,std::cout);
+
 		// calc gs energy
 		if (verbose_ && PsimagLite::Concurrency::root())
 			std::cerr<<"About to calc gs energy\n";
@@ -359,24 +381,30 @@ private:
 	                         const LeftRightSuperType& lrs,
 	                         RealType targetTime,
 	                         const TargetVectorType& initialVector,
-	                         SizeType saveOption)
+	                         SizeType saveOption,
+	                         const ParametersForSolverType& params)
 	{
 		PsimagLite::String options = parameters_.options;
 		bool dumperEnabled = (options.find("KroneckerDumper") != PsimagLite::String::npos);
+		bool dumperBinary = (options.find("KroneckerDumperBinary") != PsimagLite::String::npos);
 		ParamsForKroneckerDumperType paramsKrDumper(dumperEnabled,
 		                                            parameters_.dumperBegin,
 		                                            parameters_.dumperEnd,
-		                                            parameters_.precision);
+		                                            parameters_.precision,
+		                                            0,
+		                                            dumperBinary);
 		ParamsForKroneckerDumperType* paramsKrDumperPtr = 0;
 		if (lrs.super().block().size() == model_.geometry().numberOfSites())
 			paramsKrDumperPtr = &paramsKrDumper;
 
+		Instrumentation::Timer timer("setup");
 		HamiltonianConnectionType hc(partitionIndex,
 		                             lrs,
 		                             model_.geometry(),
 		                             model_.linkProduct(),
 		                             targetTime,
 		                             paramsKrDumperPtr);
+		timer.stop();
 
 		if (options.find("debugmatrix")!=PsimagLite::String::npos && !(saveOption & 4) ) {
 			SparseMatrixType fullm;
@@ -419,7 +447,8 @@ private:
 		                    energyTmp,
 		                    hc,
 		                    initialVector,
-		                    saveOption);
+		                    saveOption,
+		                    params);
 	}
 
 	void diagonaliseOneBlock(SizeType partitionIndex,
@@ -427,7 +456,8 @@ private:
 	                         RealType &energyTmp,
 	                         HamiltonianConnectionType& hc,
 	                         const TargetVectorType& initialVector,
-	                         SizeType saveOption)
+	                         SizeType saveOption,
+	                         const ParametersForSolverType& params)
 	{
 		int n = hc.modelHelper().size();
 		if (verbose_)
@@ -436,24 +466,37 @@ private:
 		ReflectionSymmetryType *rs = 0;
 		if (reflectionOperator_.isEnabled()) rs = &reflectionOperator_;
 
+		Instrumentation::Timer timerSetup("setup");
 		typename LanczosOrDavidsonBaseType::MatrixType lanczosHelper(model_,
 		                                                             hc,
 		                                                             rs);
+		timerSetup.stop();
 
 		if ((saveOption & 4)>0) {
 			energyTmp = slowWft(lanczosHelper, tmpVec, initialVector);
+			matvecs_ += lanczosHelper.products();
 			PsimagLite::OstringStream msg;
 			msg<<"Early exit due to user requesting (slow) WFT, energy= "<<energyTmp;
 			progress_.printline(msg,std::cout);
 			return;
 		}
 
-		ParametersForSolverType params(io_,"Lanczos");
 		LanczosOrDavidsonBaseType* lanczosOrDavidson = 0;
+		BlockDavidsonSolverType* blockDavidson = 0;
 
 		bool useDavidson = (parameters_.options.find("useDavidson") !=
 		        PsimagLite::String::npos);
-		if (useDavidson) {
+		bool excitedBlock = (parameters_.excited > 0 &&
+		                     parameters_.options.find("ExcitedBlockDavidson") !=
+		        PsimagLite::String::npos);
+		bool preconditioned = (parameters_.options.find("PreconditionedDavidson") !=
+		        PsimagLite::String::npos);
+		if (excitedBlock || preconditioned) {
+			blockDavidson = new BlockDavidsonSolverType(lanczosHelper,
+			                                            params,
+			                                            parameters_.excited + 1,
+			                                            parameters_.randomSeed);
+		} else if (useDavidson) {
 			lanczosOrDavidson = new DavidsonSolverType(lanczosHelper, params);
 		} else {
 			lanczosOrDavidson = new LanczosSolverType(lanczosHelper, params);
@@ -466,6 +509,7 @@ private:
 			msg<<" BOGUS energy= "<<energyTmp;
 			progress_.printline(msg,std::cout);
 			if (lanczosOrDavidson) delete lanczosOrDavidson;
+			if (blockDavidson) delete blockDavidson;
 			return;
 		}
 
@@ -474,7 +518,21 @@ private:
 
 
 		try {
-			energyTmp = computeLevel(*lanczosOrDavidson,tmpVec,initialVector);
+			Instrumentation::Timer timer("eigensolver");
+			if (lanczosHelper.setSolverLayout()) {
+				// permute once here instead of in each matrix vector product
+				TargetVectorType initialVector2;
+				lanczosHelper.toSolverLayout(initialVector2, initialVector);
+				TargetVectorType tmpVec2(tmpVec.size(), 0.0);
+				energyTmp = (blockDavidson) ?
+				            computeLevel(*blockDavidson,tmpVec2,initialVector2) :
+				            computeLevel(*lanczosOrDavidson,tmpVec2,initialVector2);
+				lanczosHelper.fromSolverLayout(tmpVec, tmpVec2);
+			} else {
+				energyTmp = (blockDavidson) ?
+				            computeLevel(*blockDavidson,tmpVec,initialVector) :
+				            computeLevel(*lanczosOrDavidson,tmpVec,initialVector);
+			}
 		} catch (std::exception& e) {
 			PsimagLite::OstringStream msg0;
 			msg0<<e.what()<<"\n";
@@ -495,10 +553,52 @@ private:
 			progress_.printline(msg1,std::cout);
 		}
 
+		matvecs_ += lanczosHelper.products();
 		if (lanczosOrDavidson) delete lanczosOrDavidson;
+		if (blockDavidson) delete blockDavidson;
+	}
+
+	/* With AdaptiveLanczos, in all finite loops but the last one, the
+	   tolerance is loosened to a tenth of the discarded weight of the previous
+	   step, since the truncation that follows cannot resolve more, and the
+	   steps are capped in proportion to the kept states of this loop */
+	void adaptSolverParams(ParametersForSolverType& params,
+	                       ProgramGlobals::DirectionEnum direction,
+	                       SizeType loopIndex,
+	                       RealType truncationError) const
+	{
+		if (parameters_.options.find("AdaptiveLanczos") == PsimagLite::String::npos)
+			return;
+
+		SizeType loops = parameters_.finiteLoop.size();
+		if (direction == ProgramGlobals::INFINITE || loopIndex + 1 >= loops)
+			return;
+
+		RealType tolerance = 0.1*truncationError;
+		if (tolerance > params.tolerance)
+			params.tolerance = tolerance;
+
+		SizeType maxKeptStates = 0;
+		for (SizeType i = 0; i < loops; ++i)
+			if (parameters_.finiteLoop[i].keptStates > maxKeptStates)
+				maxKeptStates = parameters_.finiteLoop[i].keptStates;
+
+		const SizeType minSteps = 20;
+		SizeType keptStates = parameters_.finiteLoop[loopIndex].keptStates;
+		SizeType steps = (maxKeptStates == 0) ? params.steps :
+		                                        params.steps*keptStates/maxKeptStates;
+		if (steps < minSteps) steps = minSteps;
+		if (steps < params.steps) params.steps = steps;
+
+		PsimagLite::OstringStream msg;
+		msg<<"AdaptiveLanczos: tolerance= "<<params.tolerance;
+		msg<<" steps= "<<params.steps<<" for discarded weight= "<<truncationError;
+		progress_.printline(msg,std::cout);
 	}
 
-	RealType computeLevel(LanczosOrDavidsonBaseType& object,
+	// object is a LanczosOrDavidsonBaseType or a BlockDavidsonSolverType
+	template<typename SomeSolverType>
+	RealType computeLevel(SomeSolverType& object,
 	                      TargetVectorType& gsVector,
 	                      const TargetVectorType& initialVector) const
 	{
@@ -565,6 +665,7 @@ private:
 	const QnType& quantumSector_;
 	WaveFunctionTransfType& wft_;
 	RealType oldEnergy_;
+	SizeType matvecs_;
 }; // class Diagonalization
 } // namespace Dmrg
 
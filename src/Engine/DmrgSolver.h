@@ -102,6 +102,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PsiBase64.h"
 #include "PrinterInDetail.h"
 #include "Io/IoSelector.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
@@ -196,7 +197,8 @@ public:
 	                model.geometry(),
 	                ioOut_),
 	      energy_(0.0),
-	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos)
+	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos),
+	      phaseTimingsCounter_(0)
 	{
 		std::cout<<appInfo_;
 		PsimagLite::OstringStream msg;
@@ -211,6 +213,9 @@ public:
 		ioOut_.write(PsimagLite::IsComplexNumber<ComplexOrRealType>::True, "IsComplex");
 		if (parameters_.options.find("verbose")!=PsimagLite::String::npos)
 			verbose_=true;
+
+		Instrumentation::init(parameters_.options.find("PhaseTimings") !=
+		        PsimagLite::String::npos);
 	}
 
 	~DmrgSolver()
@@ -380,19 +385,22 @@ obtain ordered
 			progress_.printline(msg,std::cout);
 			printerInDetail.print(std::cout, "infinite");
 
-			lrs_.growLeftBlock(model_,pS,X[step],time); // grow system
 			bool needsRightPush = false;
-			if (step < Y.size()) {
-				lrs_.growRightBlock(model_,pE,Y[step],time); // grow environment
-				needsRightPush = true;
-			}
+			{
+				Instrumentation::Timer timer("superblock");
+				lrs_.growLeftBlock(model_,pS,X[step],time); // grow system
+				if (step < Y.size()) {
+					lrs_.growRightBlock(model_,pE,Y[step],time); // grow environment
+					needsRightPush = true;
+				}
 
-			progress_.print("Growth done.\n",std::cout);
-			lrs_.printSizes("Infinite",std::cout);
+				progress_.print("Growth done.\n",std::cout);
+				lrs_.printSizes("Infinite",std::cout);
 
-			updateQuantumSector(lrs_.sites(),ProgramGlobals::INFINITE,step);
+				updateQuantumSector(lrs_.sites(),ProgramGlobals::INFINITE,step);
 
-			lrs_.setToProduct(quantumSector_);
+				lrs_.setToProduct(quantumSector_);
+			}
 
 			const BlockType& ystep = findRightBlock(Y,step,E);
 			energy_ = diagonalization_(psi,ProgramGlobals::INFINITE,X[step],ystep);
@@ -400,14 +408,18 @@ obtain ordered
 
 			truncate_.changeBasisInfinite(pS, pE, psi, parameters_.keptStatesInfinite);
 
-			if (needsRightPush) {
-				if (!twoSiteDmrg) checkpoint_.push(pS,pE);
-				else checkpoint_.push(lrs_.left(),lrs_.right());
-			} else {
-				checkpoint_.push((twoSiteDmrg) ? lrs_.left() : pS,
-				                 ProgramGlobals::SYSTEM);
+			{
+				Instrumentation::Timer timer("checkpoint");
+				if (needsRightPush) {
+					if (!twoSiteDmrg) checkpoint_.push(pS,pE);
+					else checkpoint_.push(lrs_.left(),lrs_.right());
+				} else {
+					checkpoint_.push((twoSiteDmrg) ? lrs_.left() : pS,
+					                 ProgramGlobals::SYSTEM);
+				}
 			}
 
+			writePhaseTimings();
 			progress_.printMemoryUsage();
 		}
 		progress_.print("Infinite dmrg loop has been done!\n",std::cout);
@@ -517,10 +529,12 @@ obtain ordered
 			RealType time = target.time();
 			printerInDetail.print(std::cout, "finite");
 			if (direction == ProgramGlobals::EXPAND_SYSTEM) {
-				lrs_.growLeftBlock(model_,pS,sitesIndices_[stepCurrent_],time);
+				growLeftOrRight(pS, sitesIndices_[stepCurrent_], time, direction);
+				Instrumentation::Timer timer("checkpoint");
 				lrs_.right(checkpoint_.shrink(ProgramGlobals::ENVIRON,target));
 			} else {
-				lrs_.growRightBlock(model_,pE,sitesIndices_[stepCurrent_],time);
+				growLeftOrRight(pE, sitesIndices_[stepCurrent_], time, direction);
+				Instrumentation::Timer timer("checkpoint");
 				lrs_.left(checkpoint_.shrink(ProgramGlobals::SYSTEM,target));
 			}
 
@@ -537,18 +551,24 @@ obtain ordered
 
 			updateQuantumSector(lrs_.sites(),direction,stepCurrent_);
 
-			lrs_.setToProduct(quantumSector_);
+			{
+				Instrumentation::Timer timer("superblock");
+				lrs_.setToProduct(quantumSector_);
+			}
 
 			bool needsPrinting = (saveOption & 1);
 			energy_ = diagonalization_(target,
 			                           direction,
 			                           sitesIndices_[stepCurrent_],
 			                           loopIndex,
+			                           truncate_.error(),
 			                           needsPrinting);
 			printEnergy(energy_);
 
 			changeTruncateAndSerialize(pS,pE,target,keptStates,direction,loopIndex);
 
+			writePhaseTimings();
+
 			if (finalStep(stepLength, stepFinal)) break;
 
 			if (stepCurrent_ < 0)
@@ -583,14 +603,29 @@ obtain ordered
 
 		truncate_.changeBasisFinite(pS, pE, target, keptStates, direction);
 
-		if (direction == ProgramGlobals::EXPAND_SYSTEM)
-			checkpoint_.push((twoSiteDmrg) ? lrs_.left() : pS, ProgramGlobals::SYSTEM);
-		else
-			checkpoint_.push((twoSiteDmrg) ? lrs_.right() : pE, ProgramGlobals::ENVIRON);
+		{
+			Instrumentation::Timer timer("checkpoint");
+			if (direction == ProgramGlobals::EXPAND_SYSTEM)
+				checkpoint_.push((twoSiteDmrg) ? lrs_.left() : pS, ProgramGlobals::SYSTEM);
+			else
+				checkpoint_.push((twoSiteDmrg) ? lrs_.right() : pE, ProgramGlobals::ENVIRON);
+		}
 
 		write(fsS,fsE,target,direction,loopIndex);
 	}
 
+	void growLeftOrRight(MyBasisWithOperators& pSorE,
+	                     const BlockType& block,
+	                     RealType time,
+	                     ProgramGlobals::DirectionEnum direction)
+	{
+		Instrumentation::Timer timer("superblock");
+		if (direction == ProgramGlobals::EXPAND_SYSTEM)
+			lrs_.growLeftBlock(model_, pSorE, block, time);
+		else
+			lrs_.growRightBlock(model_, pSorE, block, time);
+	}
+
 	void write(const FermionSignType& fsS,
 	           const FermionSignType& fsE,
 	           const TargetingType& target,
@@ -602,6 +637,7 @@ obtain ordered
 		if (!(saveOption & 1)) return;
 		if (!saveData_) return;
 
+		Instrumentation::Timer timer("serializer");
 		const BlockDiagonalMatrixType& transform = truncate_.transform(direction);
 		DmrgSerializerType ds(fsS,fsE,lrs_,target.gs(),transform, direction);
 
@@ -681,6 +717,12 @@ obtain ordered
 		ioOut_.writeVectorEntry(energy, "Energy", counter++);
 	}
 
+	void writePhaseTimings()
+	{
+		if (!saveData_) return;
+		Instrumentation::write(ioOut_, phaseTimingsCounter_++);
+	}
+
 	const BlockType& findRightBlock(const VectorBlockType& y,
 	                                SizeType step,
 	                                const BlockType& E) const
@@ -709,6 +751,7 @@ obtain ordered
 	ObservablesInSituType inSitu_;
 	RealType energy_;
 	bool saveData_;
+	SizeType phaseTimingsCounter_;
 }; //class DmrgSolver
 } // namespace Dmrg
 
@@ -84,6 +84,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "CrsMatrix.h"
 #include "Braket.h"
 #include "AnsiColors.h"
+#include "Concurrency.h"
+#include "TypeToString.h"
 
 namespace Dmrg {
 template<typename CorrelationsSkeletonType>
@@ -99,6 +101,7 @@ class FourPointCorrelations {
 	static SizeType const GROW_RIGHT = CorrelationsSkeletonType::GROW_RIGHT;
 	typedef typename VectorType::value_type FieldType;
 	typedef typename BasisWithOperatorsType::RealType RealType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
 
 public:
 
@@ -110,14 +113,56 @@ public:
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
 	typedef typename CorrelationsSkeletonType::BraketType BraketType;
 
+private:
+
+	// The result of firstStage for the sites, modifiers and operator labels of key
+	struct FirstStage {
+
+		PsimagLite::String key;
+		SparseMatrixType O2gt;
+	}; // struct FirstStage
+
+	// source grown by growDirectly4p from site start up to stage
+	struct GrownOperator {
+
+		GrownOperator()
+		    : start(0), fermionicSign(1), stage(0), lastUse(0)
+		{}
+
+		SparseMatrixType source;
+		SizeType start;
+		int fermionicSign;
+		SizeType stage;
+		SparseMatrixType grown;
+		SizeType lastUse;
+	}; // struct GrownOperator
+
+	typedef typename PsimagLite::Vector<FirstStage>::Type VectorFirstStageType;
+	typedef typename PsimagLite::Vector<GrownOperator>::Type VectorGrownOperatorType;
+	typedef typename PsimagLite::Vector<VectorGrownOperatorType>::Type
+	VectorVectorGrownOperatorType;
+
+	// Operators grown at the same time by a thread, for example the first two
+	// and the first three of a four-point function
+	static const SizeType grownPerThread_ = 4;
+
+public:
+
 	FourPointCorrelations(ObserverHelperType& precomp,
 	                      CorrelationsSkeletonType& skeleton,
 	                      bool verbose=false)
-	    : helper_(precomp),skeleton_(skeleton),verbose_(verbose)
+	    : helper_(precomp),
+	      skeleton_(skeleton),
+	      verbose_(verbose),
+	      firstStage_(ConcurrencyType::codeSectionParams.npthreads),
+	      grown_(ConcurrencyType::codeSectionParams.npthreads,
+	             VectorGrownOperatorType(grownPerThread_)),
+	      uses_(ConcurrencyType::codeSectionParams.npthreads, 0)
 	{
 	}
 
-	//! Four-point: these are expensive and uncached!!!
+	//! Four-point: these are expensive; each thread caches its last first
+	//! stage and its last grown operators, see firstStage and growDirectly4p
 	//! requires i1<i2<i3<i4
 	FieldType operator()(SizeType i1,
 	                     SizeType i2,
@@ -142,7 +187,7 @@ public:
 		return secondStage(O2gt,i2,'C',i3,'C',i4,braket,2,3,threadId);
 	}
 
-	//! 3-point: these are expensive and uncached!!!
+	//! 3-point: these are expensive; cached as operator()
 	//! requires i1<i2<i3
 	FieldType threePoint(SizeType i1,
 	                     SizeType i2,
@@ -162,7 +207,7 @@ public:
 		return secondStage(O2gt,i2,'N',i3,braket,2,threadId);
 	}
 
-	//! 4-points or more: these are expensive and uncached!!!
+	//! 4-points or more: these are expensive; cached as operator()
 	//! requires i0<i1<i2<i3<...<i_{n-1}
 	FieldType anyPoint(const BraketType& braket, SizeType threadId) const
 	{
@@ -218,6 +263,8 @@ public:
 	}
 
 	//! requires i1<i2
+	// The thread reuses its last O2gt if sites, modifiers and operator labels
+	// are the same
 	void firstStage(SparseMatrixType& O2gt,
 	                char mod1,
 	                SizeType i1,
@@ -228,6 +275,18 @@ public:
 	                SizeType index1,
 	                SizeType threadId) const
 	{
+		int ns = i2-1;
+		if (ns<0) ns = 0;
+
+		assert(threadId < firstStage_.size());
+		FirstStage& cached = firstStage_[threadId];
+		PsimagLite::String key = ttos(i1) + mod1 + braket.opName(index0) + ";" +
+		        ttos(i2) + mod2 + braket.opName(index1);
+		if (cached.key == key) {
+			O2gt = cached.O2gt;
+			helper_.setPointer(threadId,ns);
+			return;
+		}
 
 		// Take care of modifiers
 		SparseMatrixType O1m, O2m;
@@ -243,8 +302,6 @@ public:
 		// Multiply and grow ("snowball")
 		SparseMatrixType O1g,O2g;
 
-		int ns = i2-1;
-		if (ns<0) ns = 0;
 		skeleton_.growDirectly(O1g,O1m,i1,braket.op(index0).fermionSign,ns,true,threadId);
 		skeleton_.dmrgMultiply(O2g,O1g,O2m,braket.op(index1).fermionSign,ns,threadId);
 
@@ -254,6 +311,9 @@ public:
 			std::cerr<<"O2gt\n";
 			std::cerr<<O2gt;
 		}
+
+		cached.key = key;
+		cached.O2gt = O2gt;
 	}
 
 	//! requires i2<i3<i4
@@ -442,21 +502,82 @@ private:
 	                    SizeType ns,
 	                    SizeType threadId) const
 	{
-		Odest =Osrc;
-
 		// from 0 --> i
 		int nt=i-1;
 		if (nt<0) nt=0;
 
-		for (SizeType s=nt;s<ns;s++) {
+		// growth continues from where it stopped for this Osrc, so that growing
+		// the same operator to sites further away costs only the extra sites
+		GrownOperator& entry = cachedGrowth(Osrc,i,fermionicSign,nt,ns,threadId);
+
+		// grown keeps its storage from one site to the next
+		SparseMatrixType grown;
+		SizeType s = entry.stage;
+		for (;s<ns;s++) {
 			helper_.setPointer(threadId,s);
 			int growOption = GROW_RIGHT;
 
-			SparseMatrixType Onew(helper_.cols(threadId), helper_.cols(threadId));
-			skeleton_.fluffUp(Onew,Odest,fermionicSign,growOption,true,threadId);
-			Odest = Onew;
+			skeleton_.fluffUp(grown,entry.grown,fermionicSign,growOption,false,threadId);
+			helper_.transform(entry.grown,grown,threadId);
+		}
+
+		if (entry.stage < ns)
+			entry.stage = ns;
+		else if (ns > SizeType(nt))
+			helper_.setPointer(threadId,ns-1);
 
+		Odest = entry.grown;
+	}
+
+	// The grown operator of the thread for Osrc, i and fermionicSign, if it is
+	// not grown past ns; otherwise the least recently used one, reset to Osrc
+	GrownOperator& cachedGrowth(const SparseMatrixType& Osrc,
+	                            SizeType i,
+	                            int fermionicSign,
+	                            SizeType nt,
+	                            SizeType ns,
+	                            SizeType threadId) const
+	{
+		assert(threadId < grown_.size());
+		VectorGrownOperatorType& entries = grown_[threadId];
+		SizeType use = ++uses_[threadId];
+		SizeType oldest = 0;
+		for (SizeType e = 0; e < entries.size(); ++e) {
+			GrownOperator& entry = entries[e];
+			if (entry.lastUse > 0 && entry.start == i && entry.fermionicSign == fermionicSign &&
+			        entry.stage <= ns && equalMatrices(entry.source, Osrc)) {
+				entry.lastUse = use;
+				return entry;
+			}
+
+			if (entry.lastUse < entries[oldest].lastUse) oldest = e;
+		}
+
+		GrownOperator& entry = entries[oldest];
+		entry.source = Osrc;
+		entry.start = i;
+		entry.fermionicSign = fermionicSign;
+		entry.stage = nt;
+		entry.grown = Osrc;
+		entry.lastUse = use;
+		return entry;
+	}
+
+	static bool equalMatrices(const SparseMatrixType& a, const SparseMatrixType& b)
+	{
+		SizeType rows = a.rows();
+		if (rows != b.rows() || a.cols() != b.cols() || a.nonZeros() != b.nonZeros())
+			return false;
+
+		for (SizeType i = 0; i < rows; ++i) {
+			if (a.getRowPtr(i + 1) != b.getRowPtr(i + 1)) return false;
+			for (int k = a.getRowPtr(i); k < a.getRowPtr(i + 1); ++k) {
+				if (a.getCol(k) != b.getCol(k)) return false;
+				if (a.getValue(k) != b.getValue(k)) return false;
+			}
 		}
+
+		return true;
 	}
 
 	void checkIndicesForStrictOrdering(const BraketType& braket) const
@@ -479,6 +600,9 @@ private:
 	ObserverHelperType& helper_; // <-- NB: not the owner
 	CorrelationsSkeletonType& skeleton_; // <-- NB: not the owner
 	bool verbose_;
+	mutable VectorFirstStageType firstStage_;
+	mutable VectorVectorGrownOperatorType grown_;
+	mutable PsimagLite::Vector<SizeType>::Type uses_;
 };  //class FourPointCorrelations
 } // namespace Dmrg
 
@@ -116,6 +116,8 @@ public:
 	typedef typename LeftRightSuperType::KroneckerDumperType KroneckerDumperType;
 	typedef typename PsimagLite::Vector<LinkType>::Type VectorLinkType;
 	typedef typename LinkProductBaseType::HermitianEnum HermitianEnum;
+	typedef typename LinkProductBaseType::LinkCacheType LinkCacheType;
+	typedef typename ModelHelperType::LinkKernel LinkKernelType;
 
 	HamiltonianConnection(SizeType m,
 	                      const LeftRightSuperType& lrs,
@@ -132,14 +134,23 @@ public:
 	      systemBlock_(modelHelper_.leftRightSuper().left().block()),
 	      envBlock_(modelHelper_.leftRightSuper().right().block()),
 	      smax_(*std::max_element(systemBlock_.begin(),systemBlock_.end())),
-	      emin_(*std::min_element(envBlock_.begin(),envBlock_.end())),
-	      hamAbstract_(superGeometry_, smax_, emin_, modelHelper_.leftRightSuper().super().block()),
-	      totalOnes_(hamAbstract_.items())
+	      emin_(*std::min_element(envBlock_.begin(),envBlock_.end()))
 	{
-		lps_.reserve(ProgramGlobals::MAX_LPS);
-		SizeType nitems = hamAbstract_.items();
-		for (SizeType x = 0; x < nitems; ++x)
-			totalOnes_[x] = cacheConnections(x);
+		// links depend on smax, emin, the superblock sites, and time only
+		// so they are computed once and shared by all partitions
+		const VectorSizeType& superBlock = lrs.super().block();
+		typename LinkCacheType::Key key(smax_, emin_, superBlock);
+		LinkCacheType& linkCache = lpb_.linkCache();
+		if (!linkCache.find(lps_, totalOnes_, key, targetTime_)) {
+			HamiltonianAbstractType hamAbstract(superGeometry_, smax_, emin_, superBlock);
+			lps_.reserve(ProgramGlobals::MAX_LPS);
+			SizeType nitems = hamAbstract.items();
+			totalOnes_.resize(nitems);
+			for (SizeType x = 0; x < nitems; ++x)
+				totalOnes_[x] = cacheConnections(hamAbstract, x);
+
+			linkCache.insert(key, targetTime_, lps_, totalOnes_);
+		}
 
 		SizeType last = lrs.super().block().size();
 		assert(last > 0);
@@ -156,6 +167,13 @@ public:
 		msg<<"LinkProductStructSize="<<lps_.size();
 		progress_.printline(msg,std::cout);
 
+		SizeType hits = 0;
+		SizeType misses = 0;
+		linkCache.stats(hits, misses);
+		PsimagLite::OstringStream msg1;
+		msg1<<"LinkCacheHits="<<hits<<" LinkCacheMisses="<<misses;
+		progress_.printline(msg1,std::cout);
+
 		PsimagLite::OstringStream msg2;
 		// add left and right contributions
 		msg2<<"PthreadsTheoreticalLimitForThisPart="<<(lps_.size() + 2);
@@ -252,6 +270,49 @@ public:
 		return link2;
 	}
 
+	// d = diagonal of the Hamiltonian of this partition, as a Davidson
+	// preconditioner; costs about one product on the fly
+	void diagonal(VectorType& d) const
+	{
+		d.resize(modelHelper_.size());
+		std::fill(d.begin(), d.end(), 0.0);
+		modelHelper_.hamiltonianDiagonal(d);
+		SizeType total = lps_.size();
+		for (SizeType xx = 0; xx < total; ++xx) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			const LinkType& link2 = getKron(&A, &B, xx);
+			modelHelper_.fastOpProdInterDiagonal(d, *A, *B, link2);
+		}
+	}
+
+	// The data of link xx that do not depend on the vector, for
+	// ModelHelperType::linkProduct; with SU(2), the reduced factor tables,
+	// fermion signs and link value are folded in, and its size is that of
+	// the two operators of the link. See prepareLinkKernels
+	const LinkKernelType& linkKernel(SizeType xx) const
+	{
+		assert(xx < linkKernels_.size());
+		return linkKernels_[xx];
+	}
+
+	// Builds the kernels of linkKernel(). Called by the master thread
+	// before the threads of the matrix-vector product start; only the
+	// first call builds
+	void prepareLinkKernels() const
+	{
+		SizeType total = lps_.size();
+		if (linkKernels_.size() == total) return;
+
+		linkKernels_.resize(total);
+		for (SizeType xx = 0; xx < total; ++xx) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			const LinkType& link2 = getKron(&A, &B, xx);
+			modelHelper_.linkKernel(linkKernels_[xx], *A, *B, link2);
+		}
+	}
+
 	KroneckerDumperType& kroneckerDumper() const
 	{
 		return kroneckerDumper_;
@@ -263,9 +324,9 @@ public:
 
 private:
 
-	SizeType cacheConnections(SizeType x)
+	SizeType cacheConnections(const HamiltonianAbstractType& hamAbstract, SizeType x)
 	{
-		const VectorSizeType& hItems = hamAbstract_.item(x);
+		const VectorSizeType& hItems = hamAbstract.item(x);
 		assert(superGeometry_.connected(smax_, emin_, hItems));
 
 		ProgramGlobals::ConnectionEnum type = superGeometry_.connectionKind(smax_, hItems);
@@ -400,8 +461,8 @@ private:
 	const VectorSizeType& envBlock_;
 	SizeType smax_;
 	SizeType emin_;
-	HamiltonianAbstractType hamAbstract_;
 	VectorSizeType totalOnes_;
+	mutable typename PsimagLite::Vector<LinkKernelType>::Type linkKernels_;
 }; // class HamiltonianConnection
 } // namespace Dmrg
 
@@ -183,6 +183,7 @@ public:
 		knownLabels_.push_back("MagneticField");
 		knownLabels_.push_back("SpinOrbit");
 		knownLabels_.push_back("DegeneracyMax");
+		knownLabels_.push_back("Excited");
 		knownLabels_.push_back("JzSymmetry");
 		knownLabels_.push_back("DegeneracyMax");
 		knownLabels_.push_back("KroneckerDumperBegin");
@@ -195,6 +196,8 @@ public:
 		knownLabels_.push_back("GeometryMaxConnections");
 		knownLabels_.push_back("LanczosNoSaveLanczosVectors");
 		knownLabels_.push_back("DenseSparseThreshold");
+		knownLabels_.push_back("MemoryBudget");
+		knownLabels_.push_back("RandomSeed");
 		knownLabels_.push_back("TridiagonalEps");
 		knownLabels_.push_back("HoneycombLy");
 		knownLabels_.push_back("GeometryValueModifier");
@@ -330,7 +333,13 @@ public:
 			\item [advanceUnrestricted] Don't restrict advance time to borders
 			\item [findSymmetrySector] Find symmetry sector with lowest energy, and
 			ignore value set in TargetElectronsUp or TargetSzPlusConst
-			\item [KroneckerDumper] TBW
+			\item [KroneckerDumper] Writes the left and right Hamiltonians and
+			the links of the first matrix-vector product of each superblock
+			that covers the whole lattice, as text, to files
+			kroneckerDumperN.txt. See KroneckerDumperBegin and KroneckerDumperEnd.
+			\item [KroneckerDumperBinary] Like KroneckerDumper, but writes the
+			binary format of KronDumpFormat.h to kroneckerDumperN.bin; these
+			files can be replayed with kronReplay.
 			\item [extendedPrint] TBW
 			\item [truncationNoSvd] Do not use SVD for truncation;
 		                               use density matrix instead
@@ -338,14 +347,43 @@ public:
 			\item [setAffinities] TBW
 			\item [wftNoAccel] Disable WFT acceleration (but not the WFT itself)
 			\item [BatchedGemm] Only meaningful with MatrixVectorKron. Enables
-								batched gemm and might need plugin sc
+			batched gemm, which skips zero blocks and threads its gemms over
+			Threads; BLAS should then run with one thread. With -DPLUGIN_SC in
+			Config.make, uses plugin sc instead
 			\item [KrylovAbridge] TBW
 			\item [fixLegacyBugs] TBW
 			\item [saveDensityMatrixEigenvalues] Save DensityMatrixEigenvalues
 			                                     to the data file.
 			\item [KronNoUseLowerPart] Don't Use lower part of Kron matrix but
  recompute it instead.
+			\item [KronPatchLayout] Only meaningful with MatrixVectorKron. Keeps the
+			Lanczos or Davidson vectors in the order of the Kron patches during
+			the diagonalization, so that each matrix vector product does not have to
+			permute them.
 			\item [ProgressInUseconds] Progress in useconds instead of seconds
+			\item [PhaseTimings] Time each phase of every step (superblock,
+			Kron setup, matvec, density matrix, SVD, truncation, WFT, serializer,
+			checkpoint) and write the timings, flops, and bytes moved to the
+			output file under PhaseTimings
+			\item [ObserveToIo] Only used by observe. Write the results also to
+			Observe followed by the OutputFile name, as described in ObserveOutput
+			\item [ObserveNoText] Only used by observe, with ObserveToIo. Do not
+			print the results written to that file
+			\item [AdaptiveLanczos] In all finite loops but the last one, loosen the
+			eigensolver tolerance to a tenth of the discarded weight of the
+			previous step, if larger than LanczosEps, and cap LanczosSteps in
+			proportion to the kept states of the loop over the largest kept states
+			of all loops. The number of matrix-vector products of each step is printed
+			\item [ExcitedBlockDavidson] With Excited greater than zero, compute the
+			lowest Excited+1 levels of each sector together by block Davidson with
+			thick restart, seeded from the WFT guess and its Krylov vectors,
+			instead of one level at a time. The residuals of all levels are
+			rechecked every iteration, and only the unconverged levels are corrected
+			\item [PreconditionedDavidson] Use the Davidson of ExcitedBlockDavidson
+			also when Excited is zero. That Davidson is preconditioned with the
+			diagonal of the superblock Hamiltonian, found from the diagonals of the
+			left and right Hamiltonians and of each connection, without building
+			the matrix
 		\end{itemize}
 		*/
 	void check(const PsimagLite::String& label,
@@ -396,6 +434,7 @@ public:
 		registerOpts.push_back("advanceUnrestricted");
 		registerOpts.push_back("findSymmetrySector");
 		registerOpts.push_back("KroneckerDumper");
+		registerOpts.push_back("KroneckerDumperBinary");
 		registerOpts.push_back("doNotCheckTwoSiteDmrg");
 		registerOpts.push_back("extendedPrint");
 		registerOpts.push_back("truncationNoSvd");
@@ -407,7 +446,14 @@ public:
 		registerOpts.push_back("fixLegacyBugs");
 		registerOpts.push_back("saveDensityMatrixEigenvalues");
 		registerOpts.push_back("KronNoUseLowerPart");
+		registerOpts.push_back("KronPatchLayout");
 		registerOpts.push_back("ProgressInUseconds");
+		registerOpts.push_back("PhaseTimings");
+		registerOpts.push_back("ObserveToIo");
+		registerOpts.push_back("ObserveNoText");
+		registerOpts.push_back("AdaptiveLanczos");
+		registerOpts.push_back("ExcitedBlockDavidson");
+		registerOpts.push_back("PreconditionedDavidson");
 
 		PsimagLite::Options::Writeable optWriteable(registerOpts,
 		                                            PsimagLite::Options::Writeable::PERMISSIVE);
@@ -419,9 +465,6 @@ public:
 		if (val.find("BatchedGemm") != PsimagLite::String::npos) {
 			if (notMvk)
 				err("FATAL: BatchedGemm only with MatrixVectorKron\n");
-#ifndef PLUGIN_SC
-			err("BatchedGemm needs -DPLUGIN_SC in Config.make\n");
-#endif
 		}
 	}
 
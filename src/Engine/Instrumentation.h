@@ -0,0 +1,253 @@
+/*! \file Instrumentation.h
+ *
+ *  Named, nested timers for the phases of a DMRG step
+ *
+ *  Enabled with SolverOptions=PhaseTimings. Each timer accumulates calls,
+ *  wall time, and the flops and bytes counted by the threads while it is
+ *  active. DmrgSolver writes one record per step to the output file,
+ *  under PhaseTimings/step/phase, and then resets the records.
+ *  PhaseTimings/step/Phases holds the comma-separated list of phases of
+ *  that step; toolboxdmrg -a phaseTimings prints all records as CSV.
+ *
+ *  Timers must be started and stopped by the master thread, the one that
+ *  called init(), and debug builds assert it; counters can be incremented
+ *  by any thread, each thread into its own slot.
+ */
+#ifndef DMRG_INSTRUMENTATION_H
+#define DMRG_INSTRUMENTATION_H
+#include "Vector.h"
+#include "Concurrency.h"
+#include "ProgressIndicator.h"
+#include "TypeToString.h"
+#include <map>
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
+namespace Dmrg {
+
+class Instrumentation {
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
+	typedef PsimagLite::MemoryUsage::TimeHandle TimeHandleType;
+
+public:
+
+	struct Record {
+
+		Record() : calls(0), seconds(0.0), flops(0), bytes(0) {}
+
+		SizeType calls;
+		double seconds;
+		SizeType flops;
+		SizeType bytes;
+	}; // struct Record
+
+	// Starts timing phase name, nested inside the phase currently running
+	class Timer {
+
+	public:
+
+		Timer(PsimagLite::String name)
+		    : active_(Instrumentation::enabled())
+		{
+			if (active_) Instrumentation::begin(name);
+		}
+
+		~Timer()
+		{
+			stop();
+		}
+
+		void stop()
+		{
+			if (!active_) return;
+			Instrumentation::end();
+			active_ = false;
+		}
+
+	private:
+
+		Timer(const Timer&);
+
+		Timer& operator=(const Timer&);
+
+		bool active_;
+	}; // class Timer
+
+	// Turns timers and counters off while it lives, if suspend is true;
+	// for loops whose threads run whole products, with their own timers
+	// and counters into slot zero. Built by the master thread
+	class Suspend {
+
+	public:
+
+		Suspend(bool suspend)
+		    : saved_(Instrumentation::enabled_)
+		{
+			if (!suspend) return;
+			assert(Instrumentation::isMaster());
+			Instrumentation::enabled_ = false;
+		}
+
+		~Suspend()
+		{
+			Instrumentation::enabled_ = saved_;
+		}
+
+	private:
+
+		Suspend(const Suspend&);
+
+		Suspend& operator=(const Suspend&);
+
+		bool saved_;
+	}; // class Suspend
+
+	static void init(bool enabled)
+	{
+		enabled_ = enabled;
+		if (!enabled_) return;
+
+#ifdef USE_PTHREADS
+		master_ = pthread_self();
+#endif
+
+		SizeType threads = ConcurrencyType::storageSize(
+		            ConcurrencyType::codeSectionParams.npthreads);
+		flops_.resize(threads, 0);
+		bytes_.resize(threads, 0);
+	}
+
+	static bool enabled() { return enabled_; }
+
+	// True if called from the thread that called init()
+	static bool isMaster()
+	{
+#ifdef USE_PTHREADS
+		return (pthread_equal(master_, pthread_self()) != 0);
+#else
+		return true;
+#endif
+	}
+
+	static void addFlops(SizeType threadNum, SizeType n)
+	{
+		if (!enabled_) return;
+		assert(threadNum < flops_.size());
+		flops_[threadNum] += n;
+	}
+
+	static void addBytes(SizeType threadNum, SizeType n)
+	{
+		if (!enabled_) return;
+		assert(threadNum < bytes_.size());
+		bytes_[threadNum] += n;
+	}
+
+	// Writes the records of this step and resets them
+	template<typename IoOutType>
+	static void write(IoOutType& io, SizeType counter)
+	{
+		if (!enabled_) return;
+		assert(isMaster());
+		if (stack_.size() > 0)
+			err("Instrumentation::write(): timers still running\n");
+
+		PsimagLite::String prefix("PhaseTimings");
+		typedef typename IoOutType::Serializer SerializerType;
+		if (counter == 0) io.createGroup(prefix);
+
+		io.write(counter + 1,
+		         prefix + "/Size",
+		         (counter == 0) ? SerializerType::NO_OVERWRITE :
+		                          SerializerType::ALLOW_OVERWRITE);
+
+		prefix += ("/" + ttos(counter));
+		io.createGroup(prefix);
+
+		PsimagLite::String phases;
+		SizeType n = names_.size();
+		for (SizeType i = 0; i < n; ++i) {
+			const Record& record = records_[names_[i]];
+			PsimagLite::String label = prefix + "/" + names_[i];
+			io.createGroup(label);
+			io.write(record.calls, label + "/Calls");
+			io.write(record.seconds, label + "/Seconds");
+			io.write(record.flops, label + "/Flops");
+			io.write(record.bytes, label + "/Bytes");
+			if (i > 0) phases += ",";
+			phases += names_[i];
+		}
+
+		io.write(phases, prefix + "/Phases");
+
+		names_.clear();
+		records_.clear();
+	}
+
+private:
+
+	struct Frame {
+
+		Frame(PsimagLite::String p, SizeType f, SizeType b)
+		    : path(p), flops(f), bytes(b)
+		{}
+
+		PsimagLite::String path;
+		TimeHandleType start;
+		SizeType flops;
+		SizeType bytes;
+	}; // struct Frame
+
+	typedef PsimagLite::Vector<Frame>::Type VectorFrameType;
+	typedef std::map<PsimagLite::String, Record> MapRecordType;
+
+	static void begin(PsimagLite::String name)
+	{
+		assert(isMaster());
+		PsimagLite::String path = (stack_.size() == 0) ? name :
+		                                                  stack_.back().path + "." + name;
+		stack_.push_back(Frame(path, sum(flops_), sum(bytes_)));
+		stack_.back().start = PsimagLite::ProgressIndicator::time();
+	}
+
+	static void end()
+	{
+		TimeHandleType now = PsimagLite::ProgressIndicator::time();
+		assert(isMaster());
+		assert(stack_.size() > 0);
+		const Frame& frame = stack_.back();
+
+		if (records_.find(frame.path) == records_.end())
+			names_.push_back(frame.path);
+
+		Record& record = records_[frame.path];
+		++record.calls;
+		record.seconds += (now - frame.start).seconds();
+		record.flops += sum(flops_) - frame.flops;
+		record.bytes += sum(bytes_) - frame.bytes;
+		stack_.pop_back();
+	}
+
+	static SizeType sum(const VectorSizeType& v)
+	{
+		SizeType s = 0;
+		for (SizeType i = 0; i < v.size(); ++i) s += v[i];
+		return s;
+	}
+
+	static bool enabled_;
+	static VectorSizeType flops_;
+	static VectorSizeType bytes_;
+	static VectorFrameType stack_;
+	static VectorStringType names_;
+	static MapRecordType records_;
+#ifdef USE_PTHREADS
+	static pthread_t master_;
+#endif
+}; // class Instrumentation
+} // namespace Dmrg
+#endif // DMRG_INSTRUMENTATION_H
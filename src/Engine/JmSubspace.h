@@ -269,7 +269,7 @@ private:
 	PairType jm_;
 	SizeType nelectrons_;
 	int heavy_;
-	ClebschGordanType* cgObject_;
+	const ClebschGordanType* cgObject_;
 	PsimagLite::Vector<SizeType>::Type indices_;
 	typename PsimagLite::Vector<RealType>::Type cg_,values_;
 	typename PsimagLite::Vector<SizeType>::Type flavors_,flavorIndices_;
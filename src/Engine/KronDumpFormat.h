@@ -0,0 +1,324 @@
+#ifndef KRONDUMPFORMAT_H
+#define KRONDUMPFORMAT_H
+#include "Vector.h"
+#include "CrsMatrix.h"
+#include <fstream>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Dmrg {
+
+/* Binary format of the KroneckerDumper
+
+   The file starts with the 8 bytes of magic() followed by a header of
+   SizeType words: format version, sizeof(SizeType), sizeof of the scalar,
+   whether the scalar is complex, and the instance number.
+   Then come chunks, each made of two SizeType words, tag and payload
+   bytes, followed by the payload. Payloads are padded to 8 bytes so that
+   all arrays are aligned when the file is memory mapped.
+
+   CHUNK_BASIS       which (0 left, 1 right), size, sites, site[sites]
+   CHUNK_SECTOR      offset, size, super index of each state of the sector
+                     (left + right*leftSize)
+   CHUNK_HAMILTONIAN which, CSR
+   CHUNK_LINK        fermionOrBoson, CSR of Ahat, CSR of B
+   CHUNK_END         no payload
+
+   A CSR is rows, cols, nonzeros, rowptr[rows + 1], col[nonzeros] as SizeType,
+   followed by value[nonzeros] as scalars.
+   Ahat is A multiplied by the link value and by the fermion signs of the
+   left basis, so that the link contributes kron(B, Ahat) to the superblock
+   Hamiltonian in the ordering above.
+*/
+class KronDumpFormat {
+
+public:
+
+	enum ChunkEnum {CHUNK_BASIS = 1,
+		            CHUNK_SECTOR,
+		            CHUNK_HAMILTONIAN,
+		            CHUNK_LINK,
+		            CHUNK_END};
+
+	static const char* magic() { return "DMRGKRD1"; }
+
+	static SizeType version() { return 1; }
+
+	static SizeType padded(SizeType bytes)
+	{
+		return ((bytes + 7)/8)*8;
+	}
+
+	static void writeHeader(std::ofstream& fout,
+	                        SizeType sizeOfScalar,
+	                        bool isComplex,
+	                        SizeType instance)
+	{
+		fout.write(magic(), 8);
+		SizeType header[5] = {version(),
+		                      sizeof(SizeType),
+		                      sizeOfScalar,
+		                      (isComplex) ? 1 : 0,
+		                      instance};
+		fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+	}
+
+	static void beginChunk(std::ofstream& fout, ChunkEnum tag, SizeType bytes)
+	{
+		SizeType words[2] = {static_cast<SizeType>(tag), padded(bytes)};
+		fout.write(reinterpret_cast<const char*>(words), sizeof(words));
+	}
+
+	template<typename T>
+	static void writeArray(std::ofstream& fout, const T* ptr, SizeType n)
+	{
+		SizeType bytes = n*sizeof(T);
+		if (bytes > 0) fout.write(reinterpret_cast<const char*>(ptr), bytes);
+		static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		fout.write(zeros, padded(bytes) - bytes);
+	}
+
+	static void writeWord(std::ofstream& fout, SizeType word)
+	{
+		fout.write(reinterpret_cast<const char*>(&word), sizeof(word));
+	}
+
+	template<typename SparseMatrixType>
+	static SizeType csrBytes(const SparseMatrixType& m)
+	{
+		typedef typename SparseMatrixType::value_type ValueType;
+		SizeType nnz = m.nonZeros();
+		return (3 + m.rows() + 1 + nnz)*sizeof(SizeType) +
+		        padded(nnz*sizeof(ValueType));
+	}
+
+	template<typename SparseMatrixType>
+	static void writeCsr(std::ofstream& fout, const SparseMatrixType& m)
+	{
+		typedef typename SparseMatrixType::value_type ValueType;
+		SizeType rows = m.rows();
+		SizeType nnz = m.nonZeros();
+		writeWord(fout, rows);
+		writeWord(fout, m.cols());
+		writeWord(fout, nnz);
+
+		PsimagLite::Vector<SizeType>::Type buffer(rows + 1);
+		for (SizeType i = 0; i < rows + 1; ++i)
+			buffer[i] = m.getRowPtr(i);
+		writeArray(fout, &buffer[0], rows + 1);
+
+		buffer.resize(nnz);
+		typename PsimagLite::Vector<ValueType>::Type values(nnz);
+		for (SizeType k = 0; k < nnz; ++k) {
+			buffer[k] = m.getCol(k);
+			values[k] = m.getValue(k);
+		}
+
+		if (nnz == 0) return;
+		writeArray(fout, &buffer[0], nnz);
+		writeArray(fout, &values[0], nnz);
+	}
+}; // class KronDumpFormat
+
+// Memory maps a binary dump, and gives its contents as CrsMatrix objects
+template<typename ComplexOrRealType>
+class KronDumpReader {
+
+	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+
+public:
+
+	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	KronDumpReader(PsimagLite::String filename)
+	    : data_(0), bytes_(0), leftSize_(0), rightSize_(0), instance_(0)
+	{
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			err("KronDumpReader: cannot open " + filename + "\n");
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			err("KronDumpReader: cannot stat " + filename + "\n");
+		}
+
+		bytes_ = st.st_size;
+		void* ptr = mmap(0, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (ptr == MAP_FAILED)
+			err("KronDumpReader: cannot map " + filename + "\n");
+
+		data_ = static_cast<const char*>(ptr);
+		parse(filename);
+	}
+
+	~KronDumpReader()
+	{
+		if (data_) munmap(const_cast<char*>(data_), bytes_);
+	}
+
+	SizeType instance() const { return instance_; }
+
+	SizeType leftSize() const { return leftSize_; }
+
+	SizeType rightSize() const { return rightSize_; }
+
+	// super index left + right*leftSize() of each state of the sector
+	const VectorSizeType& sector() const { return sector_; }
+
+	const SparseMatrixType& hamiltonian(SizeType which) const
+	{
+		assert(which < 2);
+		return hamiltonian_[which];
+	}
+
+	SizeType links() const { return ahat_.size(); }
+
+	const SparseMatrixType& ahat(SizeType i) const
+	{
+		assert(i < ahat_.size());
+		return ahat_[i];
+	}
+
+	const SparseMatrixType& b(SizeType i) const
+	{
+		assert(i < b_.size());
+		return b_[i];
+	}
+
+private:
+
+	KronDumpReader(const KronDumpReader&);
+
+	KronDumpReader& operator=(const KronDumpReader&);
+
+	void parse(PsimagLite::String filename)
+	{
+		SizeType pos = 0;
+		if (bytes_ < 8 || std::memcmp(data_, KronDumpFormat::magic(), 8) != 0)
+			err("KronDumpReader: " + filename + " is not a binary KroneckerDumper file\n");
+
+		pos = 8;
+		if (word(pos) != KronDumpFormat::version())
+			err("KronDumpReader: unsupported version in " + filename + "\n");
+		if (word(pos) != sizeof(SizeType))
+			err("KronDumpReader: " + filename + " was written with another SizeType\n");
+		if (word(pos) != sizeof(ComplexOrRealType) ||
+		        word(pos) != PsimagLite::IsComplexNumber<ComplexOrRealType>::True)
+			err("KronDumpReader: " + filename + " was written with another scalar type\n");
+		instance_ = word(pos);
+
+		hamiltonian_.resize(2);
+		bool hasEnd = false;
+		while (pos < bytes_ && !hasEnd) {
+			SizeType tag = word(pos);
+			SizeType payload = word(pos);
+			SizeType next = pos + payload;
+			if (next > bytes_)
+				err("KronDumpReader: truncated chunk in " + filename + "\n");
+
+			switch (tag) {
+			case KronDumpFormat::CHUNK_BASIS:
+				readBasis(pos);
+				break;
+			case KronDumpFormat::CHUNK_SECTOR:
+				readSector(pos);
+				break;
+			case KronDumpFormat::CHUNK_HAMILTONIAN: {
+				SizeType which = word(pos);
+				if (which > 1) err("KronDumpReader: bad Hamiltonian chunk\n");
+				readCsr(hamiltonian_[which], pos);
+				break;
+			}
+			case KronDumpFormat::CHUNK_LINK: {
+				word(pos); // fermionOrBoson, already in Ahat
+				ahat_.push_back(SparseMatrixType());
+				readCsr(ahat_.back(), pos);
+				b_.push_back(SparseMatrixType());
+				readCsr(b_.back(), pos);
+				break;
+			}
+			case KronDumpFormat::CHUNK_END:
+				hasEnd = true;
+				break;
+			default:
+				break; // unknown chunks are skipped
+			}
+
+			pos = next;
+		}
+
+		if (!hasEnd)
+			std::cerr<<"KronDumpReader: WARNING: "<<filename<<" has no end chunk\n";
+	}
+
+	SizeType word(SizeType& pos) const
+	{
+		if (pos + sizeof(SizeType) > bytes_) err("KronDumpReader: unexpected end of file\n");
+		SizeType w = *reinterpret_cast<const SizeType*>(data_ + pos);
+		pos += sizeof(SizeType);
+		return w;
+	}
+
+	void readBasis(SizeType pos)
+	{
+		SizeType which = word(pos);
+		SizeType size = word(pos);
+		if (which == 0)
+			leftSize_ = size;
+		else
+			rightSize_ = size;
+	}
+
+	void readSector(SizeType pos)
+	{
+		word(pos); // offset
+		SizeType size = word(pos);
+		const SizeType* ptr = reinterpret_cast<const SizeType*>(data_ + pos);
+		sector_.assign(ptr, ptr + size);
+	}
+
+	void readCsr(SparseMatrixType& m, SizeType& pos) const
+	{
+		SizeType rows = word(pos);
+		SizeType cols = word(pos);
+		SizeType nnz = word(pos);
+		const SizeType* rowptr = reinterpret_cast<const SizeType*>(data_ + pos);
+		pos += KronDumpFormat::padded((rows + 1)*sizeof(SizeType));
+		const SizeType* col = reinterpret_cast<const SizeType*>(data_ + pos);
+		pos += KronDumpFormat::padded(nnz*sizeof(SizeType));
+		const ComplexOrRealType* value = reinterpret_cast<const ComplexOrRealType*>(data_ + pos);
+		pos += KronDumpFormat::padded(nnz*sizeof(ComplexOrRealType));
+		if (pos > bytes_) err("KronDumpReader: truncated matrix\n");
+
+		m = SparseMatrixType(rows, cols, nnz);
+		for (SizeType i = 0; i < rows; ++i) {
+			m.setRow(i, rowptr[i]);
+			for (SizeType k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+				m.setCol(k, col[k]);
+				m.setValues(k, value[k]);
+			}
+		}
+
+		m.setRow(rows, nnz);
+		m.checkValidity();
+	}
+
+	const char* data_;
+	SizeType bytes_;
+	SizeType leftSize_;
+	SizeType rightSize_;
+	SizeType instance_;
+	VectorSizeType sector_;
+	VectorSparseMatrixType hamiltonian_;
+	VectorSparseMatrixType ahat_;
+	VectorSparseMatrixType b_;
+}; // class KronDumpReader
+} // namespace Dmrg
+#endif // KRONDUMPFORMAT_H
@@ -6,6 +6,7 @@
 #include "../Version.h"
 #include "Concurrency.h"
 #include "ProgramGlobals.h"
+#include "KronDumpFormat.h"
 
 namespace Dmrg {
 
@@ -31,8 +32,14 @@ public:
 		                         SizeType b = 0,
 		                         SizeType e = 0,
 		                         SizeType p = 6,
-		                         SizeType nOfQns_ = 0)
-		    : enabled(enable), begin(b), end(e), precision(p),nOfQns(nOfQns_)
+		                         SizeType nOfQns_ = 0,
+		                         bool binary_ = false)
+		    : enabled(enable),
+		      begin(b),
+		      end(e),
+		      precision(p),
+		      nOfQns(nOfQns_),
+		      binary(binary_)
 		{}
 
 		bool enabled;
@@ -40,12 +47,13 @@ public:
 		SizeType end;
 		SizeType precision;
 		SizeType nOfQns;
+		bool binary;
 	}; // struct ParamsForKroneckerDumper
 
 	KroneckerDumper(const ParamsForKroneckerDumper* p,
 	                const LeftRightSuperType& lrs,
 	                SizeType m)
-	    : enabled_(p && p->enabled),pairCount_(0),disable_(false)
+	    : enabled_(p && p->enabled),binary_(p && p->binary),pairCount_(0),disable_(false)
 	{
 		if (!enabled_) return;
 
@@ -56,12 +64,14 @@ public:
 			return;
 		}
 
-		if (p->nOfQns == 0) {
-			PsimagLite::String msg("KroneckerDumper::ctor(): internal error ");
-			throw PsimagLite::RuntimeError(msg + "nOfQns\n");
-		}
-
 		ConcurrencyType::mutexInit(&mutex_);
+		signs_ = lrs.left().signs();
+
+		if (binary_) {
+			openBinary(lrs, m);
+			counter_++;
+			return;
+		}
 
 		PsimagLite::String filename = "kroneckerDumper" + ttos(counter_) + ".txt";
 		fout_.open(filename.c_str());
@@ -78,7 +88,6 @@ public:
 		QnType qtarget = lrs.super().qnEx(m);
 		fout_<<qtarget<<"\n";
 
-		signs_ = lrs.left().signs();
 		counter_++;
 	}
 
@@ -86,7 +95,11 @@ public:
 	{
 		if (!enabled_) return;
 
-		fout_<<"EOF\n";
+		if (binary_)
+			KronDumpFormat::beginChunk(fout_, KronDumpFormat::CHUNK_END, 0);
+		else
+			fout_<<"EOF\n";
+
 		fout_.close();
 
 		ConcurrencyType::mutexDestroy(&mutex_);
@@ -107,14 +120,27 @@ public:
 			return;
 		}
 
+		SparseMatrixType Ahat;
+		calculateAhat(Ahat,A,val,bosonOrFermion);
+
 		ConcurrencyType::mutexLock(&mutex_);
+		if (binary_) {
+			SizeType bytes = sizeof(SizeType) + KronDumpFormat::csrBytes(Ahat) +
+			        KronDumpFormat::csrBytes(B);
+			KronDumpFormat::beginChunk(fout_, KronDumpFormat::CHUNK_LINK, bytes);
+			KronDumpFormat::writeWord(fout_, bosonOrFermion);
+			KronDumpFormat::writeCsr(fout_, Ahat);
+			KronDumpFormat::writeCsr(fout_, B);
+			pairCount_++;
+			ConcurrencyType::mutexUnlock(&mutex_);
+			return;
+		}
+
 		fout_<<"START_AB_PAIR\n";
 		fout_<<"link.value="<<val<<"\n";
 		fout_<<"A"<<pairCount_<<"\n";
 		printMatrix(A);
 		fout_<<"Ahat"<<pairCount_<<"\n";
-		SparseMatrixType Ahat;
-		calculateAhat(Ahat,A,val,bosonOrFermion);
 		printMatrix(Ahat);
 		fout_<<"B"<<pairCount_<<"\n";
 		printMatrix(B);
@@ -130,21 +156,73 @@ public:
 		if (!enabled_) return;
 		if (disable_) return;
 
+		ConcurrencyType::mutexLock(&mutex_);
 		if (y_.size() == 0) y_ = y;
 		if (notFirstVector(y)) {
 			disable_ = true;
+			ConcurrencyType::mutexUnlock(&mutex_);
 			return;
 		}
 
-		if (option)
-			fout_<<"LeftHamiltonian\n";
-		else
-			fout_<<"RightHamiltonian\n";
-		printMatrix(hamiltonian);
+		if (binary_) {
+			SizeType bytes = sizeof(SizeType) + KronDumpFormat::csrBytes(hamiltonian);
+			KronDumpFormat::beginChunk(fout_, KronDumpFormat::CHUNK_HAMILTONIAN, bytes);
+			KronDumpFormat::writeWord(fout_, (option) ? 0 : 1);
+			KronDumpFormat::writeCsr(fout_, hamiltonian);
+		} else {
+			if (option)
+				fout_<<"LeftHamiltonian\n";
+			else
+				fout_<<"RightHamiltonian\n";
+			printMatrix(hamiltonian);
+		}
+
+		ConcurrencyType::mutexUnlock(&mutex_);
 	}
 
 private:
 
+	// See KronDumpFormat.h for the layout
+	void openBinary(const LeftRightSuperType& lrs, SizeType m)
+	{
+		PsimagLite::String filename = "kroneckerDumper" + ttos(counter_) + ".bin";
+		fout_.open(filename.c_str(), std::ios::binary);
+		KronDumpFormat::writeHeader(fout_,
+		                            sizeof(ComplexOrRealType),
+		                            PsimagLite::IsComplexNumber<ComplexOrRealType>::True,
+		                            counter_);
+
+		writeOneBasis(0, lrs.left());
+		writeOneBasis(1, lrs.right());
+
+		const BasisType& super = lrs.super();
+		SizeType offset = super.partition(m);
+		SizeType total = super.partition(m + 1) - offset;
+		VectorSizeType sector(total);
+		for (SizeType i = 0; i < total; ++i)
+			sector[i] = super.permutation(offset + i);
+
+		KronDumpFormat::beginChunk(fout_,
+		                           KronDumpFormat::CHUNK_SECTOR,
+		                           (2 + total)*sizeof(SizeType));
+		KronDumpFormat::writeWord(fout_, offset);
+		KronDumpFormat::writeWord(fout_, total);
+		if (total > 0) KronDumpFormat::writeArray(fout_, &sector[0], total);
+	}
+
+	void writeOneBasis(SizeType which, const BasisType& basis)
+	{
+		const VectorSizeType& sites = basis.block();
+		SizeType n = sites.size();
+		KronDumpFormat::beginChunk(fout_,
+		                           KronDumpFormat::CHUNK_BASIS,
+		                           (3 + n)*sizeof(SizeType));
+		KronDumpFormat::writeWord(fout_, which);
+		KronDumpFormat::writeWord(fout_, basis.size());
+		KronDumpFormat::writeWord(fout_, n);
+		if (n > 0) KronDumpFormat::writeArray(fout_, &sites[0], n);
+	}
+
 	void printMatrix(const SparseMatrixType& matrix)
 	{
 		fout_<<matrix.rows()<<" "<<matrix.cols()<<"\n";
@@ -210,6 +288,7 @@ private:
 
 	static SizeType counter_;
 	bool enabled_;
+	bool binary_;
 	SizeType pairCount_;
 	bool disable_;
 	VectorType y_;
@@ -0,0 +1,112 @@
+#ifndef LINKCACHE_H
+#define LINKCACHE_H
+#include "Vector.h"
+#include "Concurrency.h"
+#include <map>
+
+namespace Dmrg {
+
+// Caches the list of links of a HamiltonianConnection
+// The list depends only on smax, emin, the sites of the superblock, and time,
+// but not on the partition, so it is shared by all partitions of a superblock
+// and reused by later steps with the same boundary
+template<typename LinkType, typename RealType>
+class LinkCache {
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+public:
+
+	typedef typename PsimagLite::Vector<LinkType>::Type VectorLinkType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	struct Key {
+		Key(SizeType smax_, SizeType emin_, const VectorSizeType& superBlock_)
+		    : smax(smax_), emin(emin_), superBlock(superBlock_)
+		{}
+
+		bool operator<(const Key& other) const
+		{
+			if (smax != other.smax) return (smax < other.smax);
+			if (emin != other.emin) return (emin < other.emin);
+			return (superBlock < other.superBlock);
+		}
+
+		SizeType smax;
+		SizeType emin;
+		VectorSizeType superBlock;
+	}; // struct Key
+
+	LinkCache() : time_(0.0), hits_(0), misses_(0)
+	{
+		ConcurrencyType::mutexInit(&mutex_);
+	}
+
+	~LinkCache()
+	{
+		ConcurrencyType::mutexDestroy(&mutex_);
+	}
+
+	// Copies the cached links into lps and totalOnes; returns false if not cached
+	bool find(VectorLinkType& lps,
+	          VectorSizeType& totalOnes,
+	          const Key& key,
+	          RealType time)
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		typename MapType::const_iterator it = data_.find(key);
+		bool found = (time == time_ && it != data_.end());
+		if (found) {
+			lps = it->second.first;
+			totalOnes = it->second.second;
+			++hits_;
+		} else {
+			++misses_;
+		}
+
+		ConcurrencyType::mutexUnlock(&mutex_);
+		return found;
+	}
+
+	// Entries for a previous time are dropped, because vModifier depends on time
+	void insert(const Key& key,
+	            RealType time,
+	            const VectorLinkType& lps,
+	            const VectorSizeType& totalOnes)
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		if (time != time_) {
+			data_.clear();
+			time_ = time;
+		}
+
+		data_[key] = PairType(lps, totalOnes);
+		ConcurrencyType::mutexUnlock(&mutex_);
+	}
+
+	// Lookups that found, and did not find, their links so far
+	void stats(SizeType& hits, SizeType& misses) const
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		hits = hits_;
+		misses = misses_;
+		ConcurrencyType::mutexUnlock(&mutex_);
+	}
+
+private:
+
+	typedef std::pair<VectorLinkType, VectorSizeType> PairType;
+	typedef std::map<Key, PairType> MapType;
+
+	LinkCache(const LinkCache&);
+
+	LinkCache& operator=(const LinkCache&);
+
+	MapType data_;
+	RealType time_;
+	SizeType hits_;
+	SizeType misses_;
+	mutable ConcurrencyType::MutexType mutex_;
+}; // class LinkCache
+} // namespace Dmrg
+#endif // LINKCACHE_H
@@ -3,6 +3,7 @@
 #include "Vector.h"
 #include "ProgramGlobals.h"
 #include "PsimagLite.h"
+#include "LinkCache.h"
 
 namespace Dmrg {
 
@@ -25,6 +26,7 @@ public:
 	typedef typename ModelHelperType::OperatorType OperatorType;
 	typedef typename PsimagLite::Vector<OperatorType>::Type VectorOperatorType;
 	typedef typename PsimagLite::Vector<HermitianEnum>::Type VectorHermitianEnum;
+	typedef LinkCache<typename ModelHelperType::LinkType, RealType> LinkCacheType;
 
 	template<typename SomeInputType>
 	LinkProductBase(SomeInputType& io, PsimagLite::String terms)
@@ -67,6 +69,9 @@ public:
 		return hermit_[opsIndex];
 	}
 
+	// Links of HamiltonianConnection shared across partitions and steps
+	LinkCacheType& linkCache() const { return linkCache_; }
+
 	// List of function LinkProduct*.h of each model MUST implement
 
 	// You MUST return the number of Hamiltonian terms your model has
@@ -136,6 +141,7 @@ private:
 
 	VectorStringType termNames_;
 	mutable VectorHermitianEnum hermit_;
+	mutable LinkCacheType linkCache_;
 };
 }
 #endif // LINKPRODUCTBASE_H
@@ -0,0 +1,89 @@
+#ifndef MANY_POINT_TUPLES_H
+#define MANY_POINT_TUPLES_H
+
+#include "Vector.h"
+
+namespace Dmrg {
+
+/* Site tuples of a many-point braket, generated in lexicographic order
+
+   Site i of a tuple is fixed[i] if fixed[i] >= 0; otherwise it runs
+   from site i-1 plus one (from zero for i=0) up to but excluding
+   bounds[i]. The tuples are not stored: first() gives the first one,
+   and next() moves to the following one in place.
+*/
+class ManyPointTuples {
+
+public:
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+
+	ManyPointTuples(const VectorIntType& fixed, const VectorSizeType& bounds)
+	    : fixed_(fixed), bounds_(bounds)
+	{
+		assert(fixed_.size() == bounds_.size());
+	}
+
+	SizeType points() const { return fixed_.size(); }
+
+	// First tuple that keeps sites 0 to level-1 of tuple;
+	// returns false if there is none
+	bool first(VectorSizeType& tuple, SizeType level = 0) const
+	{
+		assert(tuple.size() == points());
+		SizeType i = fill(tuple, level);
+		return (i == points() || advance(tuple, level, i));
+	}
+
+	// Next tuple that keeps sites 0 to level-1 of tuple;
+	// returns false if there is none, and tuple is then undefined
+	bool next(VectorSizeType& tuple, SizeType level = 0) const
+	{
+		assert(tuple.size() == points());
+		return advance(tuple, level, points());
+	}
+
+private:
+
+	// Increments the sites from level to i-1, which are in bounds,
+	// until all sites are in bounds
+	bool advance(VectorSizeType& tuple, SizeType level, SizeType i) const
+	{
+		while (i > level) {
+			SizeType j = i - 1;
+			if (fixed_[j] >= 0 || ++tuple[j] >= bounds_[j]) {
+				i = j;
+				continue;
+			}
+
+			i = fill(tuple, j + 1);
+			if (i == points()) return true;
+		}
+
+		return false;
+	}
+
+	// Sets sites level and up to their lowest values;
+	// returns the first one out of bounds, or points() if none
+	SizeType fill(VectorSizeType& tuple, SizeType level) const
+	{
+		for (SizeType i = level; i < tuple.size(); ++i) {
+			if (fixed_[i] >= 0) {
+				tuple[i] = fixed_[i];
+				continue;
+			}
+
+			tuple[i] = (i == 0) ? 0 : tuple[i - 1] + 1;
+			if (tuple[i] >= bounds_[i]) return i;
+		}
+
+		return tuple.size();
+	}
+
+	VectorIntType fixed_;
+	VectorSizeType bounds_;
+}; // class ManyPointTuples
+} // namespace Dmrg
+
+#endif // MANY_POINT_TUPLES_H
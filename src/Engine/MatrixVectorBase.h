@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define DMRG_MATRIX_VECTOR_BASE_H
 
 #include <vector>
+#include "Instrumentation.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -97,10 +98,45 @@ public:
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
 
+	MatrixVectorBase() : products_(0) {}
+
+	// Number of matrix-vector products done so far
+	SizeType products() const { return products_; }
+
 	SizeType reflectionSector() const { return 0; }
 
 	void reflectionSector(SizeType) {  }
 
+	// Asks matrixVectorProduct() to take and give vectors in the layout
+	// that is best for this class, returns false if that is the layout of
+	// the sector already
+	bool setSolverLayout() { return false; }
+
+	// dest in the solver layout, src in the order of the sector
+	void toSolverLayout(VectorType& dest, const VectorType& src) const
+	{
+		dest = src;
+	}
+
+	// dest in the order of the sector, src in the solver layout
+	void fromSolverLayout(VectorType& dest, const VectorType& src) const
+	{
+		dest = src;
+	}
+
+	// d = diagonal of matrixStored
+	static void diagonal(VectorType& d, const SparseMatrixType& matrixStored)
+	{
+		SizeType rows = matrixStored.rows();
+		d.resize(rows);
+		for (SizeType i = 0; i < rows; ++i) {
+			d[i] = 0.0;
+			for (int k = matrixStored.getRowPtr(i); k < matrixStored.getRowPtr(i + 1); ++k)
+				if (matrixStored.getCol(k) == static_cast<int>(i))
+					d[i] += matrixStored.getValue(k);
+		}
+	}
+
 	void fullDiag(VectorRealType& eigs,
 	              FullMatrixType& fm,
 	              const SparseMatrixType& matrixStored,
@@ -117,6 +153,25 @@ public:
 		fm = matrixStored.toDense();
 		diag(fm,eigs,'V');
 	}
+
+protected:
+
+	void countProduct() const { ++products_; }
+
+	// Flops and bytes of x += matrixStored*y
+	static void countStored(const SparseMatrixType& matrixStored)
+	{
+		if (!Instrumentation::enabled()) return;
+		SizeType nonZeros = matrixStored.nonZeros();
+		SizeType rows = matrixStored.rows();
+		Instrumentation::addFlops(0, 2*nonZeros);
+		Instrumentation::addBytes(0, nonZeros*(sizeof(ComplexOrRealType) + sizeof(int)) +
+		                          3*rows*sizeof(ComplexOrRealType));
+	}
+
+private:
+
+	mutable SizeType products_;
 }; // class MatrixVectorBase
 } // namespace Dmrg
 
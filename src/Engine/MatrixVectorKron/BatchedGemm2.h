@@ -2,106 +2,168 @@
 #define BATCHEDGEMM_H
 #include "Vector.h"
 #include <numeric>
+#include <algorithm>
 #include "BLAS.h"
 #include "ProgressIndicator.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
+/* Computes Y = H*X, where H = sum_k A_k x B_k and X and Y are in patch order
+
+   Y_i = sum_{j,k} B_k(i,j) X_j A_k(i,j)^T, where X_j is the j-th patch of X as
+   a matrix of right times left states, and A_k(i,j) and B_k(i,j) are the
+   blocks of patches (i,j) of the k-th connection.
+   Only the triples (i,j,k) for which neither A_k(i,j) nor B_k(i,j) is zero
+   are kept, with their blocks packed dense and contiguous.
+   Each product goes in two stages, each threaded with the Parallelizer:
+   T_{ijk} = B_k(i,j) X_j, one GEMM per triple, and then
+   Y_i = sum_{j,k} T_{ijk} A_k(i,j)^T, one task per output patch i.
+   The GEMMs are called from the threads, so BLAS should run with one thread
+   (OPENBLAS_NUM_THREADS=1, MKL_NUM_THREADS=1, etc.) if Threads > 1.
+*/
 template<typename InitKronType>
 class BatchedGemm2 {
 
 	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
 	typedef typename InitKronType::GenIjPatchType GenIjPatchType;
+	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
 	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
 	typedef typename VectorType::value_type ComplexOrRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
-	typedef long int IntegerType;
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
-	typedef PsimagLite::Vector<char>::Type VectorCharType;
-	typedef typename PsimagLite::Vector<ComplexOrRealType*>::Type VectorStarType;
-	typedef typename PsimagLite::Vector<const ComplexOrRealType*>::Type VectorConstStarType;
 
-	static const int ialign_ = 32;
-	static const int idebug_ = 0; // set to 0 until it gives correct results
+	struct Block {
 
-public:
+		Block(SizeType i_, SizeType j_, SizeType k_)
+		    : i(i_), j(j_), k(k_), offsetA(0), offsetB(0), offsetT(0)
+		{}
 
-	BatchedGemm2(const InitKronType& initKron)
-	    : initKron_(initKron), progress_("BatchedGemm")
-	{
-		if (!enabled()) return;
+		SizeType i;
+		SizeType j;
+		SizeType k;
+		SizeType offsetA;
+		SizeType offsetB;
+		SizeType offsetT;
+	}; // struct Block
 
-		{
-			PsimagLite::OstringStream msg;
-			msg<<"Constructing...";
-			progress_.printline(msg,std::cout);
-		}
+	typedef typename PsimagLite::Vector<Block>::Type VectorBlockType;
 
-		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
-		SizeType noperator = initKron_.connections();
+	// T_{ijk} = B_k(i,j) X_j for each triple
+	class ParallelBx {
 
-		SizeType leftMaxState = initKron_.lrs(InitKronType::NEW).left().size();
-		SizeType rightMaxState = initKron_.lrs(InitKronType::NEW).right().size();
+	public:
 
-		int nrowAbatch = leftMaxState;
-		int ncolAbatch = leftMaxState * noperator;
+		ParallelBx(const BatchedGemm2& bg, const VectorType& vin)
+		    : bg_(bg), vin_(vin)
+		{}
 
-		int nrowBbatch = rightMaxState;
-		int ncolBbatch = rightMaxState * noperator;
+		SizeType tasks() const { return bg_.blocks_.size(); }
 
-		int ldAbatch = ialign_ * iceil(nrowAbatch, ialign_ );
-		int ldBbatch = ialign_ * iceil(nrowBbatch, ialign_ );
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			const Block& block = bg_.blocks_[taskNumber];
+			int nRi = bg_.rightPatchSize_[block.i];
+			int nRj = bg_.rightPatchSize_[block.j];
+			int nLj = bg_.leftPatchSize_[block.j];
+			SizeType j1 = bg_.initKron_.offsetForPatches(InitKronType::NEW, block.j);
+			assert(j1 + nRj*nLj <= vin_.size());
 
-		Abatch_.resize(ldAbatch, ncolAbatch);
-		Bbatch_.resize(ldBbatch, ncolBbatch);
+			psimag::BLAS::GEMM('N',
+			                   'N',
+			                   nRi,
+			                   nLj,
+			                   nRj,
+			                   1.0,
+			                   &(bg_.packedB_[block.offsetB]),
+			                   nRi,
+			                   &(vin_[j1]),
+			                   nRj,
+			                   0.0,
+			                   &(bg_.bx_[block.offsetT]),
+			                   nRi);
 
-		/*
-  -------------------------
-  fill in Abatch and Bbatch
-  -------------------------
-  */
+			Instrumentation::addFlops(threadNum, 2*nRi*nLj*nRj);
+		}
 
-		assert(ldAbatch * leftMaxState * noperator >= 1);
-		assert(ldBbatch * rightMaxState * noperator >= 1);
+	private:
 
-		for (SizeType ioperator = 0; ioperator < noperator; ++ioperator) {
-			const ArrayOfMatStructType& xiStruct = initKron_.xc(ioperator);
-			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
-				for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+		const BatchedGemm2& bg_;
+		const VectorType& vin_;
+	}; // class ParallelBx
 
-					const MatrixType& Asrc =  xiStruct(ipatch,jpatch).dense();
-					SizeType igroup = initKron_.patch(InitKronType::NEW,
-					                                  GenIjPatchType::LEFT)[ipatch];
-					SizeType jgroup = initKron_.patch(InitKronType::NEW,
-					                                  GenIjPatchType::LEFT)[jpatch];
-					int ia = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
-					int ja = initKron_.lrs(InitKronType::NEW).left().partition(jgroup);
+	// Y_i = sum_{j,k} T_{ijk} A_k(i,j)^T for each output patch i
+	class ParallelY {
 
-					mylacpy(Asrc, Abatch_, ia, ja + ioperator*leftMaxState);
-				}
+	public:
+
+		ParallelY(const BatchedGemm2& bg, VectorType& vout)
+		    : bg_(bg), vout_(vout)
+		{}
+
+		SizeType tasks() const { return bg_.leftPatchSize_.size(); }
+
+		void doTask(SizeType ipatch, SizeType threadNum)
+		{
+			int nRi = bg_.rightPatchSize_[ipatch];
+			int nLi = bg_.leftPatchSize_[ipatch];
+			SizeType i1 = bg_.initKron_.offsetForPatches(InitKronType::NEW, ipatch);
+			assert(i1 + nRi*nLi <= vout_.size());
+			ComplexOrRealType* yi = &(vout_[i1]);
+			std::fill(yi, yi + nRi*nLi, 0.0);
+
+			SizeType start = bg_.blocksOfPatch_[ipatch];
+			SizeType end = bg_.blocksOfPatch_[ipatch + 1];
+			for (SizeType b = start; b < end; ++b) {
+				const Block& block = bg_.blocks_[b];
+				int nLj = bg_.leftPatchSize_[block.j];
+				psimag::BLAS::GEMM('N',
+				                   'T',
+				                   nRi,
+				                   nLi,
+				                   nLj,
+				                   1.0,
+				                   &(bg_.bx_[block.offsetT]),
+				                   nRi,
+				                   &(bg_.packedA_[block.offsetA]),
+				                   nLi,
+				                   1.0,
+				                   yi,
+				                   nRi);
+
+				Instrumentation::addFlops(threadNum, 2*nRi*nLi*nLj);
 			}
 		}
 
-		for (SizeType ioperator = 0; ioperator < noperator; ++ioperator) {
-			const ArrayOfMatStructType& yiStruct = initKron_.yc(ioperator);
-			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
-				for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+	private:
 
-					const MatrixType& Bsrc =  yiStruct(ipatch,jpatch).dense();
-					SizeType igroup = initKron_.patch(InitKronType::NEW,
-					                                  GenIjPatchType::RIGHT)[ipatch];
-					SizeType jgroup = initKron_.patch(InitKronType::NEW,
-					                                  GenIjPatchType::RIGHT)[jpatch];
-					int ib = initKron_.lrs(InitKronType::NEW).right().partition(igroup);
-					int jb = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
+		const BatchedGemm2& bg_;
+		VectorType& vout_;
+	}; // class ParallelY
 
-					mylacpy(Bsrc, Bbatch_, ib, jb + ioperator*rightMaxState);
-				}
-			}
+	friend class ParallelBx;
+	friend class ParallelY;
+
+public:
+
+	BatchedGemm2(const InitKronType& initKron)
+	    : initKron_(initKron), progress_("BatchedGemm")
+	{
+		if (!enabled()) return;
+
+		{
+			PsimagLite::OstringStream msg;
+			msg<<"Constructing...";
+			progress_.printline(msg,std::cout);
 		}
 
+		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
+		SizeType noperator = initKron_.connections();
+
 		leftPatchSize_.resize(npatches, 0);
 		rightPatchSize_.resize(npatches, 0);
 
@@ -123,182 +185,127 @@ public:
 			rightPatchSize_[ipatch] = R2 - R1;
 		}
 
-		int leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
-		int rightMaxStates = initKron_.lrs(InitKronType::NEW).right().size();
-		int nrowA = leftMaxStates;
-		int ncolA = nrowA;
-		int nrowB = rightMaxStates;
-		int nrowBX = nrowB;
-		int ldBX = ialign_ * iceil(nrowBX, ialign_);
-		BX_.resize(ldBX,  ncolA*noperator);
+		/*
+  ---------------------------------------------------
+  find the nonzero triples, sorted by output patch,
+  and the offsets of their packed blocks
+  ---------------------------------------------------
+  */
+		SizeType sizeA = 0;
+		SizeType sizeB = 0;
+		SizeType sizeT = 0;
+		SizeType zeros = 0;
+		blocksOfPatch_.resize(npatches + 1, 0);
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			blocksOfPatch_[ipatch] = blocks_.size();
+			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
+				for (SizeType ioperator = 0; ioperator < noperator; ++ioperator) {
+					const MatrixDenseOrSparseType& Asrc = initKron_.xc(ioperator)(ipatch,
+					                                                              jpatch);
+					const MatrixDenseOrSparseType& Bsrc = initKron_.yc(ioperator)(ipatch,
+					                                                              jpatch);
+					if (Asrc.isZero() || Bsrc.isZero()) {
+						++zeros;
+						continue;
+					}
+
+					Block block(ipatch, jpatch, ioperator);
+					block.offsetA = sizeA;
+					block.offsetB = sizeB;
+					block.offsetT = sizeT;
+					sizeA += leftPatchSize_[ipatch]*leftPatchSize_[jpatch];
+					sizeB += rightPatchSize_[ipatch]*rightPatchSize_[jpatch];
+					sizeT += rightPatchSize_[ipatch]*leftPatchSize_[jpatch];
+					blocks_.push_back(block);
+				}
+			}
+		}
+
+		blocksOfPatch_[npatches] = blocks_.size();
+
+		/*
+  -------------------------
+  fill in packedA and packedB
+  -------------------------
+  */
+		packedA_.resize(sizeA, 0.0);
+		packedB_.resize(sizeB, 0.0);
+		bx_.resize(sizeT, 0.0);
+		SizeType nblocks = blocks_.size();
+		for (SizeType b = 0; b < nblocks; ++b) {
+			const Block& block = blocks_[b];
+			pack(packedA_,
+			     block.offsetA,
+			     leftPatchSize_[block.i],
+			     initKron_.xc(block.k)(block.i, block.j));
+			pack(packedB_,
+			     block.offsetB,
+			     rightPatchSize_[block.i],
+			     initKron_.yc(block.k)(block.i, block.j));
+		}
 
 		{
 			PsimagLite::OstringStream msg;
-			msg<<"Construction done.";
+			msg<<"Construction done. Blocks="<<nblocks<<" zeroBlocks="<<zeros;
+			msg<<" packedElements="<<(sizeA + sizeB + sizeT);
 			progress_.printline(msg,std::cout);
 		}
 	}
 
 	bool enabled() const { return initKron_.batchedGemm(); }
 
+	// vout = H*vin, both in patch order
 	void matrixVector(VectorType& vout, const VectorType& vin) const
 	{
 		if (!enabled())
 			err("BatchedGemm::matrixVector called but BatchedGemm not enabled\n");
 
-		/*
- ------------------
- compute  Y = H * X
- ------------------
-*/
-		int leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
-		int rightMaxStates = initKron_.lrs(InitKronType::NEW).right().size();
-		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
-		SizeType noperator = initKron_.connections();
-		int nrowA = leftMaxStates;
-		int ncolA = nrowA;
-		int nrowB = rightMaxStates;
-		int ncolB = nrowB;
-		int nrowBX = nrowB;
-		int ncolBX = ncolA * noperator;
-		int ldBX = ialign_ * iceil(nrowBX, ialign_);
-		BX_.setTo(0.0);
-
-		for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
-			long j1 = initKron_.offsetForPatches(InitKronType::NEW, jpatch);
-			int nrowX = rightPatchSize_[jpatch];
-			assert(initKron_.offsetForPatches(InitKronType::NEW, jpatch + 1) - j1 ==
-			       nrowX * leftPatchSize_[jpatch]);
-
-			/*
-	 --------------------------------------
-	 XJ = reshape( X(j1:j2), nrowX, ncolX )
-	 --------------------------------------
-	 */
-			assert(static_cast<SizeType>(j1) < vin.size());
-			int ldXJ = nrowX;
-
-			SizeType jgroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::RIGHT)[jpatch];
-			int R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
-			int R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
+		typedef PsimagLite::Parallelizer<ParallelBx> ParallelizerBxType;
+		ParallelizerBxType parallelBx(PsimagLite::Concurrency::codeSectionParams);
+		ParallelBx helperBx(*this, vin);
+		parallelBx.loopCreate(helperBx);
 
-			SizeType igroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::LEFT)[jpatch];
-			int L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
-			int L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
-
-			assert(static_cast<SizeType>(j1 + R2 - R1 - 1 + (L2 - L1 - 1)*nrowX) <
-			       vin.size());
-			/*
-	 -------------------------------
-	 independent DGEMM in same group
-	 -------------------------------
-	 */
-			for (SizeType k = 0; k < noperator; ++k) {
-				int offsetB = k*ncolB;
-				int offsetBX = k*ncolA;
-				/*
-		------------------------------------------------------------------------
-		BX(1:nrowBX, offsetBX + (L1:L2)) = Bbatch(1:nrowBX, offsetB + (R1:R2) ) *
-											 XJ( 1:(R2-R1+1), 1:(L2-L1+1));
-		------------------------------------------------------------------------
-		*/
-				psimag::BLAS::GEMM('N',
-				                   'N',
-				                   nrowBX,
-				                   L2 - L1,
-				                   R2 - R1,
-				                   1.0,
-				                   &(Bbatch_(0, offsetB + R1)),
-				                   Bbatch_.rows(),
-				                   &(vin[j1]),
-				                   ldXJ,
-				                   0.0,
-				                   &(BX_(0, offsetBX + L1)),
-				                   ldBX);
-			}
-		}
-
-		/*
- -------------------------------------------------
- perform computations with  Y += (BX)*transpose(A)
- -------------------------------------------------
-*/
-		for(SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
-
-			long i1 = initKron_.offsetForPatches(InitKronType::NEW, ipatch);
-
-
-			SizeType jgroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::RIGHT)[ipatch];
-			SizeType R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
-			SizeType R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
-
-			SizeType igroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::LEFT)[ipatch];
-			SizeType L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
-			SizeType L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
-
-			assert(R2 - R1 == rightPatchSize_[ipatch] &&
-			       L2 - L1 == leftPatchSize_[ipatch]);
-
-			assert(static_cast<SizeType>(i1) < vout.size());
-			ComplexOrRealType *YI = &(vout[i1]);
-			int nrowYI = R2 - R1;
-			int ldYI = nrowYI;
-			int ncolYI = L2 - L1;
-			assert(static_cast<int>(initKron_.offsetForPatches(InitKronType::NEW, ipatch + 1) - i1) ==
-			       nrowYI * ncolYI);
-
-			/*
-		--------------------------------------------------------------------
-		YI(1:(R2-R1+1),1:(L2-L1+1)) = BX( R1:R2,1:ncolBX) *
-										 transpose( Abatch( L1:L2,1:ncolBX) );
-		--------------------------------------------------------------------
-	  */
-			psimag::BLAS::GEMM('N',
-			                   'T',
-			                   nrowYI,
-			                   ncolYI,
-			                   ncolBX,
-			                   1.0,
-			                   &(BX_(R1, 0)),
-			                   BX_.rows(),
-			                   &(Abatch_(L1, 0)),
-			                   Abatch_.rows(),
-			                   0.0,
-			                   YI,
-			                   ldYI);
-		}
+		typedef PsimagLite::Parallelizer<ParallelY> ParallelizerYType;
+		ParallelizerYType parallelY(PsimagLite::Concurrency::codeSectionParams);
+		ParallelY helperY(*this, vout);
+		parallelY.loopCreate(helperY);
 	}
 
 private:
 
-	static int iceil(int x, int n)
+	// Copies m, dense or sparse, to dest starting at offset, column major
+	static void pack(VectorType& dest,
+	                 SizeType offset,
+	                 SizeType ld,
+	                 const MatrixDenseOrSparseType& m)
 	{
-		return (x + n - 1)/n;
-	}
+		assert(m.rows() == ld);
+		if (m.isDense()) {
+			const MatrixType& a = m.dense();
+			SizeType rows = a.rows();
+			SizeType cols = a.cols();
+			for (SizeType j = 0; j < cols; ++j)
+				for (SizeType i = 0; i < rows; ++i)
+					dest[offset + i + j*ld] = a(i, j);
+			return;
+		}
 
-	static void mylacpy(const MatrixType& a,
-	                    MatrixType& b,
-	                    SizeType xstart,
-	                    SizeType ystart)
-	{
-		int m = a.rows();
-		int n = a.cols();
-		for (int j = 0; j < n; ++j)
-			for (int i = 0; i < m; ++i)
-				b(i + xstart, j + ystart) = a(i, j);
+		const SparseMatrixType& a = m.sparse();
+		SizeType rows = a.rows();
+		for (SizeType i = 0; i < rows; ++i)
+			for (int k = a.getRowPtr(i); k < a.getRowPtr(i + 1); ++k)
+				dest[offset + i + a.getCol(k)*ld] = a.getValue(k);
 	}
 
 	const InitKronType& initKron_;
 	PsimagLite::ProgressIndicator progress_;
-	MatrixType Abatch_;
-	MatrixType Bbatch_;
-	mutable MatrixType BX_;
 	VectorSizeType leftPatchSize_;
 	VectorSizeType rightPatchSize_;
+	VectorBlockType blocks_;
+	VectorSizeType blocksOfPatch_;
+	VectorType packedA_;
+	VectorType packedB_;
+	mutable VectorType bx_;
 };
 }
 #endif // BATCHEDGEMM_H
@@ -310,11 +310,11 @@ protected:
 	}
 
 	// -------------------
-	// copy xout(:) to vout(:)
+	// map[ip] is the index in the sector of the ip-th element of the
+	// patch ordered vectors
 	// -------------------
-	void copyOut(VectorType& vout,
-	             const VectorType& xout,
-	             const VectorSizeType& vstart) const
+	void setUpPatchToSector(VectorSizeType& map,
+	                        const VectorSizeType& vstart) const
 	{
 		const VectorSizeType& permInverse = lrs(NEW).super().permutationInverse();
 		SizeType offset1 = offset(NEW);
@@ -323,6 +323,9 @@ protected:
 		const BasisType& left = lrs(NEW).left();
 		const BasisType& right = lrs(NEW).right();
 
+		assert(vstart.size() == npatches + 1);
+		map.resize(vstart[npatches]);
+
 		for( SizeType ipatch=0; ipatch < npatches; ++ipatch) {
 
 			SizeType igroup = patch(NEW, GenIjPatchType::LEFT)[ipatch];
@@ -352,10 +355,9 @@ protected:
 					assert( !(  (r < offset1) || (r >= (offset1 + size(NEW))) ) );
 
 					SizeType ip = vstart[ipatch] + (iright + ileft * sizeRight);
-					assert(ip < xout.size());
+					assert(ip < map.size());
 
-					assert(r >= offset1 && ((r - offset1) < vout.size()) );
-					vout[r-offset1] = xout[ip];
+					map[ip] = r - offset1;
 				}
 			}
 		}
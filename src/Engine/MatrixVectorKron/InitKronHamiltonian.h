@@ -128,6 +128,7 @@ public:
 		yin_.resize(nsize, 0.0);
 		xout_.resize(nsize, 0.0);
 		BaseType::computeOffsets(offsetForPatches_, BaseType::NEW);
+		BaseType::setUpPatchToSector(patchToSector_, vstart_);
 	}
 
 	bool isWft() const {return false; }
@@ -138,62 +139,13 @@ public:
 	}
 
 	// -------------------
-	// copy vin(:) to yin(:)
+	// copy vin(:) to yin(:) and vout(:) to xout(:)
 	// -------------------
 	void copyIn(const VectorType& vout,
 	            const VectorType& vin)
 	{
-		VectorType& xout = xout_;
-		VectorType& yin = yin_;
-
-		const VectorSizeType& permInverse = BaseType::lrs(BaseType::NEW).super().permutationInverse();
-		const SparseMatrixType& leftH = BaseType::lrs(BaseType::NEW).left().hamiltonian();
-		SizeType nl = leftH.rows();
-
-		SizeType offset = BaseType::offset(BaseType::NEW);
-		SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
-		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
-		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
-
-		for (SizeType ipatch=0; ipatch < npatches; ++ipatch) {
-
-			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
-			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
-
-			assert(left.partition(igroup+1) >= left.partition(igroup));
-			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
-
-			assert(right.partition(jgroup+1) >= right.partition(jgroup));
-			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
-
-			SizeType left_offset = left.partition(igroup);
-			SizeType right_offset = right.partition(jgroup);
-
-			for (SizeType ileft=0; ileft < sizeLeft; ++ileft) {
-				for (SizeType iright=0; iright < sizeRight; ++iright) {
-
-					SizeType i = ileft + left_offset;
-					SizeType j = iright + right_offset;
-
-					SizeType ij = i + j * nl;
-
-					assert(i < nl);
-					assert(j < BaseType::lrs(BaseType::NEW).right().hamiltonian().rows());
-
-					assert(ij < permInverse.size());
-
-					SizeType r = permInverse[ ij ];
-					assert(!((r < offset) || (r >= (offset + BaseType::size(BaseType::NEW)))));
-
-					SizeType ip = vstart_[ipatch] + (iright + ileft * sizeRight);
-					assert(ip < yin.size());
-
-					assert( (r >= offset) && ((r-offset) < vin.size()) );
-					yin[ip] = vin[r-offset];
-					xout[ip] = vout[r-offset];
-				}
-			}
-		}
+		toPatches(xout_, vout);
+		toPatches(yin_, vin);
 	}
 
 	// -------------------
@@ -201,7 +153,35 @@ public:
 	// -------------------
 	void copyOut(VectorType& vout) const
 	{
-		BaseType::copyOut(vout, xout_, vstart_);
+		fromPatches(vout, xout_);
+	}
+
+	// dest in patch order, src in the order of the sector
+	void toPatches(VectorType& dest, const VectorType& src) const
+	{
+		SizeType n = patchToSector_.size();
+		dest.resize(n);
+		for (SizeType ip = 0; ip < n; ++ip) {
+			assert(patchToSector_[ip] < src.size());
+			dest[ip] = src[patchToSector_[ip]];
+		}
+	}
+
+	// dest in the order of the sector, src in patch order
+	void fromPatches(VectorType& dest, const VectorType& src) const
+	{
+		SizeType n = patchToSector_.size();
+		assert(src.size() == n);
+		for (SizeType ip = 0; ip < n; ++ip) {
+			assert(patchToSector_[ip] < dest.size());
+			dest[patchToSector_[ip]] = src[ip];
+		}
+	}
+
+	// true if the patches cover the whole sector
+	bool patchesCoverSector() const
+	{
+		return (patchToSector_.size() == BaseType::size(BaseType::NEW));
 	}
 
 	const VectorType& yin() const { return yin_; }
@@ -283,6 +263,7 @@ private:
 	VectorSizeType vstart_;
 	VectorType yin_;
 	VectorType xout_;
+	VectorSizeType patchToSector_;
 	VectorSizeType offsetForPatches_;
 };
 } // namespace Dmrg
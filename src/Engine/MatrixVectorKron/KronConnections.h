@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "Matrix.h"
 #include "Concurrency.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
@@ -110,12 +111,21 @@ public:
 	      y_(initKron.yin())
 	{}
 
+	// x and y in patch order
+	KronConnections(const InitKronType& initKron,
+	                VectorType& x,
+	                const VectorType& y)
+	    : initKron_(initKron),
+	      x_(x),
+	      y_(y)
+	{}
+
 	SizeType tasks() const
 	{
 		return initKron_.numberOfPatches(InitKronType::NEW);
 	}
 
-	void doTask(SizeType outPatch, SizeType)
+	void doTask(SizeType outPatch, SizeType threadNum)
 	{
 		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
 
@@ -154,6 +164,9 @@ public:
 				         Amat,
 				         Bmat,
 				         initKron_.denseFlopDiscount());
+
+				if (Instrumentation::enabled())
+					countKronMult(Amat, Bmat, threadNum);
 			}
 		}
 	}
@@ -162,6 +175,20 @@ public:
 
 private:
 
+	// Flops and bytes of kronMult, as in estimate_kron_cost without discount
+	static void countKronMult(const MatrixDenseOrSparseType& A,
+	                          const MatrixDenseOrSparseType& B,
+	                          SizeType threadNum)
+	{
+		SizeType nnzA = (A.isDense()) ? A.rows()*A.cols() : A.sparse().nonZeros();
+		SizeType nnzB = (B.isDense()) ? B.rows()*B.cols() : B.sparse().nonZeros();
+		SizeType method1 = nnzB*A.cols() + nnzA*B.rows();
+		SizeType method2 = nnzA*B.cols() + nnzB*A.rows();
+		Instrumentation::addFlops(threadNum, 2*std::min(method1, method2));
+		SizeType vectors = A.cols()*B.cols() + A.rows()*B.rows();
+		Instrumentation::addBytes(threadNum, (nnzA + nnzB + vectors)*sizeof(ComplexOrRealType));
+	}
+
 	// disable copy ctor
 	KronConnections(const KronConnections&);
 
@@ -126,19 +126,24 @@ public:
 	void matrixVectorProduct(VectorType& vout, const VectorType& vin) const
 	{
 		initKron_.copyIn(vout, vin);
+		matrixVectorProductPatched(initKron_.xout(), initKron_.yin());
+		initKron_.copyOut(vout);
+	}
 
+	// xout += H*yin, with xout and yin in patch order;
+	// see InitKronHamiltonian::toPatches()
+	void matrixVectorProductPatched(VectorType& xout, const VectorType& yin) const
+	{
 		if (batchedGemm_.enabled()) {
-			VectorType& xout = initKron_.xout();
 			VectorType xoutTmp(xout.size(), 0.0);
-			batchedGemm_.matrixVector(xoutTmp, initKron_.yin());
+			batchedGemm_.matrixVector(xoutTmp, yin);
 			for(SizeType i = 0; i < xoutTmp.size(); ++i)
 				xout[i] += xoutTmp[i];
 
-			initKron_.copyOut(vout);
 			return;
 		}
 
-		KronConnectionsType kc(initKron_);
+		KronConnectionsType kc(initKron_, xout, yin);
 
 		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
 		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
@@ -149,8 +154,6 @@ public:
 			parallelConnections.loopCreate(kc);
 
 		kc.sync();
-
-		initKron_.copyOut(vout);
 	}
 
 private:
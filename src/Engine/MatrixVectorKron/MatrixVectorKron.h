@@ -84,6 +84,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "InitKronHamiltonian.h"
 #include "KronMatrix.h"
 #include "MatrixVectorBase.h"
+#include "Instrumentation.h"
+#include "MemoryBudget.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -109,16 +111,29 @@ public:
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
 	typedef typename SparseMatrixType::value_type value_type;
 	typedef typename ModelType::HamiltonianConnectionType HamiltonianConnectionType;
+	typedef MemoryBudget<HamiltonianConnectionType> MemoryBudgetType;
 
 	MatrixVectorKron(const ModelType& model,
 	                 const HamiltonianConnectionType& hc,
 	                 ReflectionSymmetryType* = 0)
-	    : params_(model.params()),
-	      initKron_(model, hc),
-	      kronMatrix_(initKron_, "Hamiltonian")
+	    : model_(model),
+	      hc_(hc),
+	      params_(model.params()),
+	      initKron_(0),
+	      kronMatrix_(0),
+	      patchLayout_(false)
 	{
+		bool batchedGemm = (params_.options.find("BatchedGemm") != PsimagLite::String::npos);
+		MemoryBudgetType memoryBudget(params_.memoryBudget,
+		                              params_.denseSparseThreshold,
+		                              batchedGemm);
+		typename MemoryBudgetType::StrategyEnum strategy = memoryBudget.choose(hc);
+		if (strategy == MemoryBudgetType::STRATEGY_KRON)
+			strategy = initKron();
+
 		int maxMatrixRankStored = model.params().maxMatrixRankStored;
-		if (hc.modelHelper().size() > maxMatrixRankStored) return;
+		bool small = (hc.modelHelper().size() <= maxMatrixRankStored);
+		if (!small && strategy != MemoryBudgetType::STRATEGY_STORED) return;
 
 		model.fullHamiltonian(matrixStored_, hc);
 		assert(isHermitian(matrixStored_,true));
@@ -126,15 +141,81 @@ public:
 		checkKron();
 	}
 
-	SizeType rows() const { return initKron_.size(InitKronType::NEW); }
+	~MatrixVectorKron()
+	{
+		delete kronMatrix_;
+		kronMatrix_ = 0;
+		delete initKron_;
+		initKron_ = 0;
+	}
+
+	SizeType rows() const { return hc_.modelHelper().size(); }
+
+	// With SolverOptions=KronPatchLayout the vectors of the eigensolver are
+	// kept in the patch order of InitKronHamiltonian, so that the products
+	// do not permute them in and out
+	bool setSolverLayout()
+	{
+		if (params_.options.find("KronPatchLayout") == PsimagLite::String::npos)
+			return false;
+		if (!kronMatrix_ || matrixStored_.rows() > 0)
+			return false;
+		if (!initKron_->patchesCoverSector())
+			return false;
+
+		patchLayout_ = true;
+		return true;
+	}
+
+	void toSolverLayout(VectorType& dest, const VectorType& src) const
+	{
+		if (!patchLayout_) {
+			dest = src;
+			return;
+		}
+
+		initKron_->toPatches(dest, src);
+	}
+
+	void fromSolverLayout(VectorType& dest, const VectorType& src) const
+	{
+		if (!patchLayout_) {
+			dest = src;
+			return;
+		}
+
+		dest.resize(src.size());
+		initKron_->fromPatches(dest, src);
+	}
 
 	template<typename SomeVectorType>
 	void matrixVectorProduct(SomeVectorType &x,SomeVectorType const &y) const
 	{
-		if (matrixStored_.rows() > 0)
+		Instrumentation::Timer timer("matvec");
+		BaseType::countProduct();
+		if (matrixStored_.rows() > 0) {
+			BaseType::countStored(matrixStored_);
 			matrixStored_.matrixVectorProduct(x,y);
-		else
-			kronMatrix_.matrixVectorProduct(x,y);
+		} else if (patchLayout_) {
+			kronMatrix_->matrixVectorProductPatched(x,y);
+		} else if (kronMatrix_) {
+			kronMatrix_->matrixVectorProduct(x,y);
+		} else {
+			model_.matrixVectorProduct(x, y, hc_);
+		}
+	}
+
+	// Diagonal of the matrix, for preconditioning, in the solver layout
+	void diagonal(VectorType& d) const
+	{
+		if (matrixStored_.rows() > 0) {
+			BaseType::diagonal(d, matrixStored_);
+			return;
+		}
+
+		VectorType tmp;
+		hc_.diagonal(tmp);
+		toSolverLayout(d, tmp);
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
@@ -144,6 +225,27 @@ public:
 
 private:
 
+	// Falls back to the product on the fly if the Kronecker structures
+	// do not fit in memory after all
+	typename MemoryBudgetType::StrategyEnum initKron()
+	{
+		Instrumentation::Timer timer("kronSetup");
+		try {
+			initKron_ = new InitKronType(model_, hc_);
+			kronMatrix_ = new KronMatrixType(*initKron_, "Hamiltonian");
+		} catch (std::bad_alloc&) {
+			delete kronMatrix_;
+			kronMatrix_ = 0;
+			delete initKron_;
+			initKron_ = 0;
+			std::cerr<<"WARNING: MatrixVectorKron: out of memory, ";
+			std::cerr<<"using the product on the fly\n";
+			return MemoryBudgetType::STRATEGY_ONTHEFLY;
+		}
+
+		return MemoryBudgetType::STRATEGY_KRON;
+	}
+
 	void checkKron() const
 	{
 		if (!CHECK_KRON)
@@ -153,6 +255,8 @@ private:
 		return;
 #endif
 
+		if (!kronMatrix_) return;
+
 		SizeType n = rows();
 		std::cout<<n<<"\n";
 		FullMatrixType m(n, n);
@@ -160,7 +264,7 @@ private:
 			VectorType e(n, 0.0);
 			e[i] = 1.0;
 			VectorType ey(n, 0.0);
-			kronMatrix_.matrixVectorProduct(ey,e);
+			kronMatrix_->matrixVectorProduct(ey,e);
 			for (SizeType j = 0; j < n; ++j)
 				m(i, j) = ey[j];
 
@@ -173,10 +277,17 @@ private:
 		std::cout<<matrixStored_;
 	}
 
+	MatrixVectorKron(const MatrixVectorKron&);
+
+	MatrixVectorKron& operator=(const MatrixVectorKron&);
+
+	const ModelType& model_;
+	const HamiltonianConnectionType& hc_;
 	const ParametersType& params_;
-	InitKronType initKron_;
-	KronMatrixType kronMatrix_;
+	InitKronType* initKron_;
+	KronMatrixType* kronMatrix_;
 	SparseMatrixType matrixStored_;
+	bool patchLayout_;
 }; // class MatrixVectorKron
 } // namespace Dmrg
 
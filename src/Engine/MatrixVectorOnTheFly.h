@@ -82,6 +82,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include <vector>
 #include "MatrixVectorBase.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -119,10 +120,23 @@ public:
 	template<typename SomeVectorType>
 	void matrixVectorProduct(SomeVectorType &x,SomeVectorType const &y) const
 	{
-		if (matrixStored_.rows() > 0)
+		Instrumentation::Timer timer("matvec");
+		BaseType::countProduct();
+		if (matrixStored_.rows() > 0) {
+			BaseType::countStored(matrixStored_);
 			matrixStored_.matrixVectorProduct(x,y);
-		else
+		} else {
 			model_.matrixVectorProduct(x, y, hc_);
+		}
+	}
+
+	// Diagonal of the matrix, for preconditioning
+	void diagonal(typename BaseType::VectorType& d) const
+	{
+		if (matrixStored_.rows() > 0)
+			BaseType::diagonal(d, matrixStored_);
+		else
+			hc_.diagonal(d);
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
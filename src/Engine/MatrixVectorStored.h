@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <vector>
 #include "ProgressIndicator.h"
 #include "MatrixVectorBase.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -111,6 +112,7 @@ public:
 	      pointer_(0),
 	      progress_("MatrixVectorStored")
 	{
+		Instrumentation::Timer timer("matrixStored");
 		PsimagLite::String options = model.params().options;
 		bool debugMatrix = (options.find("debugmatrix") != PsimagLite::String::npos);
 		if (!rs) {
@@ -139,6 +141,9 @@ public:
 	template<typename SomeVectorType>
 	void matrixVectorProduct(SomeVectorType &x, SomeVectorType const &y) const
 	{
+		Instrumentation::Timer timer("matvec");
+		BaseType::countProduct();
+		BaseType::countStored(matrixStored_[pointer_]);
 		matrixStored_[pointer_].matrixVectorProduct(x,y);
 	}
 
@@ -151,6 +156,12 @@ public:
 
 	void reflectionSector(SizeType p) { pointer_=p; }
 
+	// Diagonal of the matrix, for preconditioning
+	void diagonal(typename BaseType::VectorType& d) const
+	{
+		BaseType::diagonal(d, matrixStored_[pointer_]);
+	}
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
 	{
 		BaseType::fullDiag(eigs,
@@ -0,0 +1,180 @@
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+#include "Vector.h"
+#include "Concurrency.h"
+#include "ProgressIndicator.h"
+#include <fstream>
+
+namespace Dmrg {
+
+/* PSIDOC MemoryBudget
+ With MemoryBudget=integer in the input, in megabytes, MatrixVectorKron
+ estimates before each diagonalization the memory that each way of doing
+ the matrix-vector product would need, and uses the fastest one that fits
+ in the budget together with what the process already uses (stacks,
+ bases, WFT vectors, etc.), in this order: the Kronecker product, the
+ stored matrix, and the product on the fly. The product on the fly is used
+ if nothing fits, with a warning.
+ Superblocks with at most MaxMatrixRankStored states are still stored.
+ */
+template<typename HamiltonianConnectionType>
+class MemoryBudget {
+
+	typedef typename HamiltonianConnectionType::ModelHelperType ModelHelperType;
+	typedef typename ModelHelperType::SparseMatrixType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename ModelHelperType::RealType RealType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+public:
+
+	enum StrategyEnum {STRATEGY_KRON, STRATEGY_STORED, STRATEGY_ONTHEFLY};
+
+	// budget in megabytes, zero means no budget
+	MemoryBudget(SizeType budget,
+	             RealType denseSparseThreshold,
+	             bool batchedGemm)
+	    : budget_(budget*1024*1024),
+	      denseSparseThreshold_(denseSparseThreshold),
+	      batchedGemm_(batchedGemm),
+	      progress_("MemoryBudget")
+	{}
+
+	StrategyEnum choose(const HamiltonianConnectionType& hc) const
+	{
+		if (budget_ == 0) return STRATEGY_KRON;
+
+		SizeType resident = residentBytes();
+		SizeType kron = kronBytes(hc);
+		SizeType stored = storedBytes(hc);
+		SizeType onTheFly = onTheFlyBytes(hc);
+
+		StrategyEnum strategy = STRATEGY_ONTHEFLY;
+		if (resident + kron <= budget_)
+			strategy = STRATEGY_KRON;
+		else if (resident + stored <= budget_)
+			strategy = STRATEGY_STORED;
+
+		PsimagLite::OstringStream msg;
+		msg<<"resident="<<megabytes(resident)<<"MB kron="<<megabytes(kron);
+		msg<<"MB stored="<<megabytes(stored)<<"MB onTheFly="<<megabytes(onTheFly);
+		msg<<"MB budget="<<megabytes(budget_)<<"MB using "<<name(strategy);
+		progress_.printline(msg, std::cout);
+
+		if (strategy == STRATEGY_ONTHEFLY && resident + onTheFly > budget_)
+			std::cerr<<"WARNING: MemoryBudget exceeded even with the product on the fly\n";
+
+		return strategy;
+	}
+
+	static PsimagLite::String name(StrategyEnum strategy)
+	{
+		if (strategy == STRATEGY_KRON) return "kron";
+		if (strategy == STRATEGY_STORED) return "stored";
+		return "onTheFly";
+	}
+
+	// Resident set size of this process, or zero if not available
+	static SizeType residentBytes()
+	{
+		std::ifstream fin("/proc/self/status");
+		PsimagLite::String label;
+		while (fin>>label) {
+			if (label != "VmRSS:") continue;
+			SizeType kb = 0;
+			fin>>kb;
+			return kb*1024;
+		}
+
+		return 0;
+	}
+
+private:
+
+	// Patches of A and B for each link, as in InitKronBase, the input and output
+	// vectors, and the dense A and B per link if BatchedGemm is used
+	SizeType kronBytes(const HamiltonianConnectionType& hc) const
+	{
+		SizeType n = hc.modelHelper().size();
+		SizeType bytes = 2*n*sizeof(ComplexOrRealType);
+		bytes += patchesBytes(hamiltonian(hc, true));
+		bytes += patchesBytes(hamiltonian(hc, false));
+		SizeType links = hc.tasks();
+		for (SizeType i = 0; i < links; ++i) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			hc.getKron(&A, &B, i);
+			bytes += patchesBytes(*A) + patchesBytes(*B);
+			if (!batchedGemm_) continue;
+			bytes += (A->rows()*A->cols() + B->rows()*B->cols())*sizeof(ComplexOrRealType);
+		}
+
+		return bytes;
+	}
+
+	// Nonzeros of the sector are estimated from the nonzeros per row of each term;
+	// fullHamiltonian holds two copies while building
+	SizeType storedBytes(const HamiltonianConnectionType& hc) const
+	{
+		SizeType n = hc.modelHelper().size();
+		RealType perRow = perRowOf(hamiltonian(hc, true)) + perRowOf(hamiltonian(hc, false));
+		SizeType links = hc.tasks();
+		for (SizeType i = 0; i < links; ++i) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			hc.getKron(&A, &B, i);
+			perRow += perRowOf(*A)*perRowOf(*B);
+		}
+
+		SizeType nonZeros = static_cast<SizeType>(n*std::min(perRow, static_cast<RealType>(n)));
+		SizeType matrix = nonZeros*(sizeof(ComplexOrRealType) + sizeof(int)) + (n + 1)*sizeof(int);
+		return 2*matrix;
+	}
+
+	// One temporary vector per thread, as in ParallelHamiltonianConnection
+	SizeType onTheFlyBytes(const HamiltonianConnectionType& hc) const
+	{
+		SizeType n = hc.modelHelper().size();
+		SizeType threads = ConcurrencyType::storageSize(
+		            ConcurrencyType::codeSectionParams.npthreads);
+		return (threads + 2)*n*sizeof(ComplexOrRealType);
+	}
+
+	// MatrixDenseOrSparse stores a block dense if its density exceeds the threshold
+	SizeType patchesBytes(const SparseMatrixType& m) const
+	{
+		SizeType rows = m.rows();
+		SizeType cols = m.cols();
+		SizeType nonZeros = m.nonZeros();
+		SizeType dense = rows*cols*sizeof(ComplexOrRealType);
+		if (rows*cols > 0 && nonZeros > denseSparseThreshold_*rows*cols)
+			return dense;
+
+		return nonZeros*(sizeof(ComplexOrRealType) + sizeof(int)) + (rows + 1)*sizeof(int);
+	}
+
+	static const SparseMatrixType& hamiltonian(const HamiltonianConnectionType& hc,
+	                                           bool left)
+	{
+		return (left) ? hc.modelHelper().leftRightSuper().left().hamiltonian() :
+		                hc.modelHelper().leftRightSuper().right().hamiltonian();
+	}
+
+	static RealType perRowOf(const SparseMatrixType& m)
+	{
+		SizeType rows = m.rows();
+		return (rows == 0) ? 0 : static_cast<RealType>(m.nonZeros())/rows;
+	}
+
+	static SizeType megabytes(SizeType bytes)
+	{
+		return bytes/(1024*1024);
+	}
+
+	SizeType budget_;
+	RealType denseSparseThreshold_;
+	bool batchedGemm_;
+	mutable PsimagLite::ProgressIndicator progress_;
+}; // class MemoryBudget
+} // namespace Dmrg
+#endif // MEMORYBUDGET_H
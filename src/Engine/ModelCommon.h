@@ -176,6 +176,9 @@ public:
 		typedef PsimagLite::Parallelizer<ParallelHamConnectionType> ParallelizerType;
 		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
 
+		if (ModelHelperType::isSu2())
+			hc.prepareLinkKernels();
+
 		ParallelHamConnectionType phc(x, y, hc);
 		parallelConnections.loopCreate(phc);
 
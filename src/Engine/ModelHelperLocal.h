@@ -108,6 +108,16 @@ public:
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
 	typedef typename BasisType::QnType QnType;
 
+	// As in ModelHelperSu2; here the kernel of a link is the link itself
+	struct LinkKernel {
+
+		LinkKernel() : left(0), right(0), link(0) {}
+
+		SparseMatrixType const* left;
+		SparseMatrixType const* right;
+		const LinkType* link;
+	}; // struct LinkKernel
+
 	ModelHelperLocal(SizeType m, const LeftRightSuperType& lrs)
 	    : m_(m),
 	      lrs_(lrs),
@@ -365,6 +375,65 @@ public:
 		}
 	}
 
+	// link must outlive the kernel
+	void linkKernel(LinkKernel& kernel,
+	                const SparseMatrixType& A,
+	                const SparseMatrixType& B,
+	                const LinkType& link) const
+	{
+		kernel.left = &A;
+		kernel.right = &B;
+		kernel.link = &link;
+	}
+
+	void linkProduct(VectorSparseElementType& x,
+	                 const VectorSparseElementType& y,
+	                 const LinkKernel& kernel) const
+	{
+		fastOpProdInter(x, y, *kernel.left, *kernel.right, *kernel.link);
+	}
+
+	// Does d += the diagonal of (AB), as in fastOpProdInter
+	void fastOpProdInterDiagonal(VectorSparseElementType& d,
+	                             const SparseMatrixType& A,
+	                             const SparseMatrixType& B,
+	                             const LinkType& link) const
+	{
+		RealType fermionSign =  (link.fermionOrBoson==ProgramGlobals::FERMION) ? -1 : 1;
+
+		if (link.type==ProgramGlobals::ENVIRON_SYSTEM)  {
+			LinkType link2 = link;
+			link2.value *= fermionSign;
+			link2.type = ProgramGlobals::SYSTEM_ENVIRON;
+			fastOpProdInterDiagonal(d,B,A,link2);
+			return;
+		}
+
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+
+		for (int i=0;i<total;++i) {
+			SparseElementType fsValue = (fermionSign < 0 && fermionSigns_[i])
+			        ? -link.value
+			        : link.value;
+
+			d[i] += diagonalElement(A,alpha_[i])*diagonalElement(B,beta_[i])*fsValue;
+		}
+	}
+
+	// Does d += the diagonal of the products of hamiltonianLeftProduct and
+	// hamiltonianRightProduct
+	void hamiltonianDiagonal(VectorSparseElementType& d) const
+	{
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+		const SparseMatrixType& left = lrs_.left().hamiltonian();
+		const SparseMatrixType& right = lrs_.right().hamiltonian();
+
+		for (int i=0;i<total;++i)
+			d[i] += diagonalElement(left,alpha_[i]) + diagonalElement(right,beta_[i]);
+	}
+
 	// if option==true let H_{alpha,beta; alpha',beta'} =
 	// basis2.hamiltonian_{alpha,alpha'} \delta_{beta,beta'}
 	// if option==false let  H_{alpha,beta; alpha',beta'} =
@@ -428,6 +497,14 @@ public:
 
 private:
 
+	static SparseElementType diagonalElement(const SparseMatrixType& m, SizeType row)
+	{
+		for (int k=m.getRowPtr(row);k<m.getRowPtr(row+1);k++)
+			if (m.getCol(k)==static_cast<int>(row)) return m.getValue(k);
+
+		return 0.0;
+	}
+
 	void createBuffer()
 	{
 		SizeType ns=lrs_.left().size();
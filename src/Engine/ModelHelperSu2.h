@@ -91,6 +91,9 @@ template<typename LeftRightSuperType_>
 class ModelHelperSu2  {
 
 	typedef std::pair<SizeType,SizeType> PairType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
 
 public:
 
@@ -111,11 +114,29 @@ public:
 	typedef typename LeftRightSuperType::ParamsForKroneckerDumperType
 	ParamsForKroneckerDumperType;
 
+	// What fastOpProdInter needs of a link that does not depend on the vector:
+	// the operator of the left block with the link value, the angular factor
+	// and the fermion signs folded into its rows, the j of the column of each
+	// nonzero of both operators (times jMax for the right one), and the table
+	// of reduced factors. It takes the size of the two operators
+	struct LinkKernel {
+
+		LinkKernel() : right(0), lfactors(0) {}
+
+		SparseMatrixType left;
+		SparseMatrixType const* right;
+		VectorSizeType jOfLeftCol;
+		VectorSizeType jOfRightCol;
+		const PsimagLite::Matrix<SparseElementType>* lfactors;
+	}; // struct LinkKernel
+
 	ModelHelperSu2(int m, const LeftRightSuperType& lrs)
 	    : m_(m),
 	      lrs_(lrs),
 	      su2reduced_(m,lrs)
-	{}
+	{
+		buildTables();
+	}
 
 	const SparseMatrixType& reducedOperator(char modifier,
 	                                        SizeType i,
@@ -177,48 +198,34 @@ public:
 
 		matrixBlock.resize(total,total);
 
-		BlockType lElectrons;
-		lrs_.left().su2ElectronsBridge(lElectrons);
+		const PsimagLite::Matrix<SparseElementType>& lfactors =
+		        su2reduced_.reducedFactors(link.angularMomentum, link.category, flip);
+		SizeType jMax = lrs_.left().jMax();
 		SizeType counter=0;
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(matrixBlock.rows())) continue;
+			int ix = rowOf_[i];
+			if (ix<0) continue;
 			matrixBlock.setRow(ix,counter);
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
-			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
-
-			assert(lrs_.left().reducedIndex(i1) < lElectrons.size());
-			SizeType n1 = lElectrons[lrs_.left().reducedIndex(i1)];
-			RealType fsign=1;
-			if (n1>0 && n1%2!=0) fsign= fermionSign;
-
-			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
-			SizeType lf1 =jm1.first + jm2.first*lrs_.left().jMax();
+			RealType fsign = (oddLeft_[i1]) ? fermionSign : 1;
+			SizeType lf1 = jLeft_[i1] + jRight_[i2]*jMax;
 
 			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
 				SizeType i1prime = A.getCol(k1);
-				PairType jm1prime = lrs_.left().jmValue(lrs_.left().
-				                                        reducedIndex(i1prime));
+				SizeType j1prime = jLeft_[i1prime];
 
 				for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
 					SizeType i2prime = B.getCol(k2);
-					PairType jm2prime = lrs_.right().jmValue(lrs_.right().
-					                                         reducedIndex(i2prime));
-					SparseElementType lfactor;
-					SizeType lf2 =jm1prime.first + jm2prime.first*lrs_.left().jMax();
-					lfactor=su2reduced_.reducedFactor(link.angularMomentum,
-					                                  link.category,
-					                                  flip,
-					                                  lf1,
-					                                  lf2);
+					SizeType lf2 = j1prime + jRight_[i2prime]*jMax;
+					SparseElementType lfactor = lfactors(lf1, lf2);
 					if (lfactor==static_cast<SparseElementType>(0)) continue;
 
 					lfactor *= link.angularFactor;
 
 					int jx = su2reduced_.flavorMapping(i1prime,i2prime)-offset;
-					if (jx<0 || jx >= int(matrixBlock.rows()) ) continue;
+					if (jx<0 || jx >= total) continue;
 
 					matrixBlock.pushCol(jx);
 					matrixBlock.pushValue(fsign*link.value*lfactor*
@@ -254,42 +261,28 @@ public:
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
-		BlockType lElectrons;
-		lrs_.left().su2ElectronsBridge(lElectrons);
+		const PsimagLite::Matrix<SparseElementType>& lfactors =
+		        su2reduced_.reducedFactors(link.angularMomentum, link.category, flipped);
+		SizeType jMax = lrs_.left().jMax();
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			int ix = rowOf_[i];
+			if (ix<0) continue;
+			assert(ix < int(x.size()));
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
-			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
-			assert(lrs_.left().reducedIndex(i1) < lElectrons.size());
-			SizeType n1= lElectrons[lrs_.left().reducedIndex(i1)];
-			RealType fsign=1;
-
-			if (n1>0 && n1%2!=0) fsign= fermionSign;
-
-			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
-			SizeType lf1 =jm1.first + jm2.first*lrs_.left().jMax();
+			RealType fsign = (oddLeft_[i1]) ? fermionSign : 1;
+			SizeType lf1 = jLeft_[i1] + jRight_[i2]*jMax;
 
 			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
 				SizeType i1prime = A.getCol(k1);
-				PairType jm1prime = lrs_.left().jmValue(lrs_.left().
-				                                        reducedIndex(i1prime));
+				SizeType j1prime = jLeft_[i1prime];
 
 				for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
 					SizeType i2prime = B.getCol(k2);
-					PairType jm2prime = lrs_.right().jmValue(lrs_.right().
-					                                         reducedIndex(i2prime));
-					SparseElementType lfactor;
-					SizeType lf2 =jm1prime.first + jm2prime.first*lrs_.left().jMax();
-
-					lfactor=su2reduced_.reducedFactor(link.angularMomentum,
-					                                  link.category,
-					                                  flipped,
-					                                  lf1,
-					                                  lf2);
+					SizeType lf2 = j1prime + jRight_[i2prime]*jMax;
+					SparseElementType lfactor = lfactors(lf1, lf2);
 					if (lfactor==static_cast<SparseElementType>(0)) continue;
 					lfactor *= link.angularFactor;
 
@@ -303,6 +296,92 @@ public:
 		}
 	}
 
+	// Builds the kernel of the link of A and B for linkProduct
+	void linkKernel(LinkKernel& kernel,
+	                SparseMatrixType const &A,
+	                SparseMatrixType const &B,
+	                const LinkType& link) const
+	{
+		RealType fermionSign = (link.fermionOrBoson==ProgramGlobals::FERMION) ? -1 : 1;
+		bool flipped = (link.type == ProgramGlobals::ENVIRON_SYSTEM);
+		const SparseMatrixType& left = (flipped) ? B : A;
+		const SparseMatrixType& right = (flipped) ? A : B;
+		SparseElementType value = link.value*link.angularFactor;
+		if (flipped) value *= fermionSign;
+
+		SizeType rows = left.rows();
+		assert(rows <= oddLeft_.size());
+		kernel.left.resize(rows, left.cols());
+		kernel.jOfLeftCol.resize(left.nonZeros());
+		SizeType counter = 0;
+		for (SizeType i1 = 0; i1 < rows; ++i1) {
+			kernel.left.setRow(i1, counter);
+			SparseElementType rowValue = (oddLeft_[i1]) ? fermionSign*value : value;
+			for (int k1 = left.getRowPtr(i1); k1 < left.getRowPtr(i1 + 1); ++k1) {
+				SizeType i1prime = left.getCol(k1);
+				kernel.left.pushCol(i1prime);
+				kernel.left.pushValue(rowValue*left.getValue(k1));
+				kernel.jOfLeftCol[counter++] = jLeft_[i1prime];
+			}
+		}
+
+		kernel.left.setRow(rows, counter);
+		kernel.left.checkValidity();
+
+		SizeType jMax = lrs_.left().jMax();
+		SizeType nonZeros = right.nonZeros();
+		kernel.jOfRightCol.resize(nonZeros);
+		for (SizeType k2 = 0; k2 < nonZeros; ++k2)
+			kernel.jOfRightCol[k2] = jRight_[right.getCol(k2)]*jMax;
+
+		kernel.right = &right;
+		kernel.lfactors = &su2reduced_.reducedFactors(link.angularMomentum,
+		                                              link.category,
+		                                              flipped);
+	}
+
+	// Does x += (AB)y as fastOpProdInter, with the kernel of the link
+	void linkProduct(VectorSparseElementType& x,
+	                 const VectorSparseElementType& y,
+	                 const LinkKernel& kernel) const
+	{
+		int offset = lrs_.super().partition(m_);
+		int total = y.size();
+		const SparseMatrixType& A = kernel.left;
+		const SparseMatrixType& B = *kernel.right;
+		const PsimagLite::Matrix<SparseElementType>& lfactors = *kernel.lfactors;
+		SizeType jMax = lrs_.left().jMax();
+
+		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
+			int ix = rowOf_[i];
+			if (ix<0) continue;
+			assert(ix < int(x.size()));
+
+			SizeType i1=su2reduced_.reducedEffective(i).first;
+			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType lf1 = jLeft_[i1] + jRight_[i2]*jMax;
+			SparseElementType sum = 0.0;
+
+			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
+				SizeType i1prime = A.getCol(k1);
+				SizeType j1prime = kernel.jOfLeftCol[k1];
+				SparseElementType a = A.getValue(k1);
+
+				for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
+					SparseElementType lfactor = lfactors(lf1, j1prime + kernel.jOfRightCol[k2]);
+					if (lfactor==static_cast<SparseElementType>(0)) continue;
+
+					int jx = su2reduced_.flavorMapping(i1prime,B.getCol(k2))-offset;
+					if (jx<0 || jx >= total) continue;
+
+					sum += lfactor*a*B.getValue(k2)*y[jx];
+				}
+			}
+
+			x[ix] += sum;
+		}
+	}
+
 	// Let H_{alpha,beta; alpha',beta'} = basis2.hamiltonian_{alpha,alpha'}
 	// delta_{beta,beta'}
 	// Let H_m be  the m-th block (in the ordering of basis1) of H
@@ -318,22 +397,17 @@ public:
 		const SparseMatrixType& A = su2reduced_.hamiltonianLeft();
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			int ix = rowOf_[i];
+			if (ix<0) continue;
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
-
-			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
-			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
+			SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jLeft_[i1],
+			                                                               jRight_[i2]);
+			if (lfactor==static_cast<SparseElementType>(0)) continue;
 
 			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
 				SizeType i1prime = A.getCol(k1);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
-				                                                               jm2.first);
-
-				if (lfactor==static_cast<SparseElementType>(0)) continue;
-
 				int jx = su2reduced_.flavorMapping(i1prime,i2)-offset;
 				if (jx<0 || jx >= int(y.size()) ) continue;
 
@@ -356,20 +430,17 @@ public:
 		const SparseMatrixType& B = su2reduced_.hamiltonianRight();
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			int ix = rowOf_[i];
+			if (ix<0) continue;
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
-			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
-			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
+			SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jLeft_[i1],
+			                                                               jRight_[i2]);
+			if (lfactor==static_cast<SparseElementType>(0)) continue;
 
 			for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
 				SizeType i2prime = B.getCol(k2);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
-				                                                               jm2.first);
-				if (lfactor==static_cast<SparseElementType>(0)) continue;
-
 				int jx = su2reduced_.flavorMapping(i1,i2prime)-offset;
 				if (jx<0 || jx >= int(y.size()) ) continue;
 
@@ -378,6 +449,84 @@ public:
 		}
 	}
 
+	// Does d += the diagonal of the link term that fastOpProdInter applies
+	void fastOpProdInterDiagonal(VectorSparseElementType& d,
+	                             SparseMatrixType const &A,
+	                             SparseMatrixType const &B,
+	                             const LinkType& link,
+	                             bool flipped=false) const
+	{
+		RealType fermionSign =  (link.fermionOrBoson==ProgramGlobals::FERMION) ? -1 : 1;
+
+		if (link.type == ProgramGlobals::ENVIRON_SYSTEM)  {
+			LinkType link2 = link;
+			link2.value *= fermionSign;
+			link2.type = ProgramGlobals::SYSTEM_ENVIRON;
+			fastOpProdInterDiagonal(d,B,A,link2,true);
+			return;
+		}
+
+		int offset = lrs_.super().partition(m_);
+		const PsimagLite::Matrix<SparseElementType>& lfactors =
+		        su2reduced_.reducedFactors(link.angularMomentum, link.category, flipped);
+		SizeType jMax = lrs_.left().jMax();
+
+		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
+			int ix = rowOf_[i];
+			if (ix<0) continue;
+
+			SizeType i1=su2reduced_.reducedEffective(i).first;
+			SizeType i2=su2reduced_.reducedEffective(i).second;
+			RealType fsign = (oddLeft_[i1]) ? fermionSign : 1;
+			SizeType lf1 = jLeft_[i1] + jRight_[i2]*jMax;
+
+			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
+				SizeType i1prime = A.getCol(k1);
+				SizeType j1prime = jLeft_[i1prime];
+
+				for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
+					SizeType i2prime = B.getCol(k2);
+					int jx = su2reduced_.flavorMapping(i1prime,i2prime)-offset;
+					if (jx != ix) continue;
+
+					SizeType lf2 = j1prime + jRight_[i2prime]*jMax;
+					SparseElementType lfactor = lfactors(lf1, lf2)*link.angularFactor;
+					d[ix] += fsign*link.value*lfactor*A.getValue(k1)*B.getValue(k2);
+				}
+			}
+		}
+	}
+
+	// Does d += the diagonal of the products of hamiltonianLeftProduct and
+	// hamiltonianRightProduct
+	void hamiltonianDiagonal(VectorSparseElementType& d) const
+	{
+		int offset = lrs_.super().partition(m_);
+		const SparseMatrixType& A = su2reduced_.hamiltonianLeft();
+		const SparseMatrixType& B = su2reduced_.hamiltonianRight();
+
+		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
+			int ix = rowOf_[i];
+			if (ix<0) continue;
+
+			SizeType i1=su2reduced_.reducedEffective(i).first;
+			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jLeft_[i1],
+			                                                               jRight_[i2]);
+			if (lfactor==static_cast<SparseElementType>(0)) continue;
+
+			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
+				int jx = su2reduced_.flavorMapping(A.getCol(k1),i2)-offset;
+				if (jx == ix) d[ix] += A.getValue(k1);
+			}
+
+			for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
+				int jx = su2reduced_.flavorMapping(i1,B.getCol(k2))-offset;
+				if (jx == ix) d[ix] += B.getValue(k2);
+			}
+		}
+	}
+
 	//! Note: USed only for debugging
 	void calcHamiltonianPartLeft(SparseMatrixType &matrixBlock) const
 	{
@@ -476,9 +625,50 @@ public:
 
 private:
 
+	// Tables used by the products above, so that the inner loops do not
+	// go through jmValue(), reducedIndex() and su2ElectronsBridge():
+	// j of each reduced state of left and right, row in partition m_ of
+	// each reduced effective state (or -1 if not in it), and whether each
+	// reduced state of left has an odd number of electrons
+	void buildTables()
+	{
+		const BasisWithOperatorsType& left = lrs_.left();
+		const BasisWithOperatorsType& right = lrs_.right();
+
+		SizeType nLeft = left.reducedSize();
+		jLeft_.resize(nLeft);
+		oddLeft_.resize(nLeft);
+		BlockType lElectrons;
+		left.su2ElectronsBridge(lElectrons);
+		for (SizeType i1 = 0; i1 < nLeft; ++i1) {
+			SizeType r = left.reducedIndex(i1);
+			jLeft_[i1] = left.jmValue(r).first;
+			assert(r < lElectrons.size());
+			oddLeft_[i1] = (lElectrons[r]%2 != 0);
+		}
+
+		SizeType nRight = right.reducedSize();
+		jRight_.resize(nRight);
+		for (SizeType i2 = 0; i2 < nRight; ++i2)
+			jRight_[i2] = right.jmValue(right.reducedIndex(i2)).first;
+
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+		SizeType n = su2reduced_.reducedEffectiveSize();
+		rowOf_.resize(n);
+		for (SizeType i = 0; i < n; ++i) {
+			int ix = su2reduced_.flavorMapping(i) - offset;
+			rowOf_[i] = (ix < 0 || ix >= total) ? -1 : ix;
+		}
+	}
+
 	int m_;
 	const LeftRightSuperType&  lrs_;
 	Su2Reduced<LeftRightSuperType> su2reduced_;
+	VectorSizeType jLeft_;
+	VectorSizeType jRight_;
+	VectorIntType rowOf_;
+	VectorBoolType oddLeft_;
 };
 } // namespace Dmrg
 /*@}*/
@@ -0,0 +1,47 @@
+#ifndef NO_NESTED_THREADS_H
+#define NO_NESTED_THREADS_H
+
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+/* Sets Concurrency::codeSectionParams.npthreads to 1 while it lives, if
+   active is true, and restores it afterwards.
+
+   For loops whose tasks are themselves threaded code, for example the
+   brakets of CorrelationsSkeleton: with it, the tasks run that code
+   serially instead of starting threads inside threads. Build it after
+   the helper of the loop, since helpers size their per-thread storage
+   from npthreads, and give the outer Parallelizer threads().
+*/
+class NoNestedThreads {
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+public:
+
+	explicit NoNestedThreads(bool active = true)
+	    : threads_(ConcurrencyType::codeSectionParams.npthreads)
+	{
+		if (active) ConcurrencyType::codeSectionParams.npthreads = 1;
+	}
+
+	~NoNestedThreads()
+	{
+		ConcurrencyType::codeSectionParams.npthreads = threads_;
+	}
+
+	// npthreads before this object was built
+	SizeType threads() const { return threads_; }
+
+private:
+
+	NoNestedThreads(const NoNestedThreads&);
+
+	NoNestedThreads& operator=(const NoNestedThreads&);
+
+	SizeType threads_;
+}; // class NoNestedThreads
+} // namespace Dmrg
+
+#endif // NO_NESTED_THREADS_H
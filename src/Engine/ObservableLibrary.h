@@ -81,8 +81,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Matrix.h" // in PsimagLite
 #include "PreOperatorSiteDependent.h"
 #include "PreOperatorSiteIndependent.h"
+#include "Parallel1PointCorrelations.h"
+#include "NoNestedThreads.h"
 #include "Concurrency.h"
 #include "Vector.h"
+#include <map>
 
 namespace Dmrg {
 
@@ -107,9 +110,17 @@ public:
 	typedef PreOperatorBase<ModelType> PreOperatorBaseType;
 	typedef PreOperatorSiteDependent<ModelType> PreOperatorSiteDependentType;
 	typedef PreOperatorSiteIndependent<ModelType> PreOperatorSiteIndependentType;
+	typedef Parallel1PointCorrelations<ObserverType,
+	                                   ApplyOperatorType,
+	                                   PreOperatorBaseType> Parallel1PointType;
 	typedef typename ObserverType::BraketType BraketType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef std::pair<SizeType,SizeType> PairSizeType;
+	typedef typename ObserverType::TwoPointCorrelatorType TwoPointCorrelatorType;
+	typedef typename ObserverType::VectorTwoPointCorrelatorType VectorTwoPointCorrelatorType;
+	typedef typename PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
+	typedef std::map<PsimagLite::String, MatrixType> MapStringMatrixType;
+	typedef typename ObserverType::ObserveOutputType ObserveOutputType;
 
 	template<typename IoInputter>
 	ObservableLibrary(IoInputter& io,
@@ -119,10 +130,12 @@ public:
 	                  SizeType start,
 	                  SizeType nf,
 	                  SizeType trail,
-	                  bool verbose)
+	                  bool verbose,
+	                  ObserveOutputType& output)
 	    : numberOfSites_(numberOfSites),
 	      hasTimeEvolution_(hasTimeEvolution),
 	      model_(model),
+	      output_(output),
 	      observe_(io, start, nf, trail, hasTimeEvolution, model, verbose)
 	{
 		PsimagLite::String modelName = model.params().model;
@@ -164,6 +177,57 @@ public:
 		}
 	}
 
+	// Computes in one pass all two-point brakets without sites that items,
+	// the labels and brakets of the observe line, will need.
+	// measureTriage() and interpret() then take them from here
+	void plan(const VectorStringType& items, SizeType rows, SizeType cols, SizeType orbitals)
+	{
+		// Immm supports only onepoint, see measureTriage()
+		if (model_.params().model == "Immm") return;
+
+		VectorStringType brakets;
+		for (SizeType i = 0; i < items.size(); ++i) {
+			const PsimagLite::String& item = items[i];
+			if (item.length() == 0 || item.find("%") == 0) continue;
+
+			if (item[0] != '<') {
+				labelBrakets(brakets, item, orbitals);
+				continue;
+			}
+
+			VectorStringType vecStr;
+			PsimagLite::split(vecStr, item, ",");
+			brakets.insert(brakets.end(), vecStr.begin(), vecStr.end());
+		}
+
+		// correlators with the same bra and ket go together
+		typedef std::map<PsimagLite::String, VectorStringType> MapStringVectorType;
+		MapStringVectorType groups;
+		for (SizeType i = 0; i < brakets.size(); ++i) {
+			BraketType braket(model_, brakets[i]);
+			if (!isTwoPointWithoutSites(braket)) continue;
+			if (fused_.find(braket.toString()) != fused_.end()) continue;
+			fused_[braket.toString()] = MatrixType(rows, cols);
+			groups[braket.bra() + "|" + braket.ket()].push_back(brakets[i]);
+		}
+
+		typename MapStringVectorType::const_iterator it = groups.begin();
+		for (; it != groups.end(); ++it) {
+			const VectorStringType& group = it->second;
+			VectorTwoPointCorrelatorType correlators;
+			for (SizeType i = 0; i < group.size(); ++i) {
+				BraketType braket(model_, group[i]);
+				if (i == 0) observe_.setBrakets(braket.bra(), braket.ket());
+				correlators.push_back(TwoPointCorrelatorType(&fused_[braket.toString()],
+				                                             braket.op(0).data,
+				                                             braket.op(1).data,
+				                                             braket.op(0).fermionSign));
+			}
+
+			observe_.twoPoint(correlators);
+		}
+	}
+
 	void measureTriage(const PsimagLite::String& label,
 	                   SizeType rows,
 	                   SizeType cols,
@@ -202,6 +266,58 @@ public:
 
 private:
 
+	// The brakets that measure(label, ...) will use, for the labels
+	// that use brakets
+	void labelBrakets(VectorStringType& brakets,
+	                  const PsimagLite::String& label,
+	                  SizeType orbitals) const
+	{
+		if (label == "cc") {
+			brakets.push_back("<gs|c?0-;c'?0-|gs>");
+			brakets.push_back("<gs|c?1-;c'?1-|gs>");
+			return;
+		}
+
+		if (label == "dd") {
+			brakets.push_back("<gs|d;d'|gs>");
+			return;
+		}
+
+		bool ss = (label == "ss");
+		for (SizeType i = 0; i < orbitals; ++i) {
+			for (SizeType j = i; j < orbitals; ++j) {
+				if (ss || label == "szsz")
+					brakets.push_back(orbitalsBraket("z", i, "z", j));
+				if (ss || label == "s+s-")
+					brakets.push_back(orbitalsBraket("splus", i, "sminus", j));
+				if (ss || label == "s-s+")
+					brakets.push_back(orbitalsBraket("sminus", i, "splus", j));
+			}
+		}
+	}
+
+	static PsimagLite::String orbitalsBraket(PsimagLite::String op1,
+	                                         SizeType i,
+	                                         PsimagLite::String op2,
+	                                         SizeType j)
+	{
+		return "<gs|" + op1 + "?" + ttos(i) + ";" + op2 + "?" + ttos(j) + "|gs>";
+	}
+
+	static bool isTwoPointWithoutSites(const BraketType& braket)
+	{
+		if (braket.points() != 2) return false;
+
+		for (SizeType i = 0; i < 2; ++i) {
+			try {
+				braket.site(i);
+				return false;
+			} catch (std::exception&) {}
+		}
+
+		return true;
+	}
+
 	void setBrakets(const PsimagLite::String& left,
 	                const PsimagLite::String& right)
 	{
@@ -229,58 +345,51 @@ private:
 	                     const PreOperatorBaseType& preOperator,
 	                     const PsimagLite::String& ket)
 	{
-		SizeType threadId = preOperator.threadId();
-		VectorFieldType density;
+		bool text = output_.text();
+		observe_.setBrakets(bra,ket);
+		Parallel1PointType values(observe_, preOperator, numberOfSites_, !hasTimeEvolution_);
+		observe_.onePoint(values);
 
+		output_.begin("<" + bra + "|" + preOperator.label() + "|" + ket + ">", 0.0, 1);
 		for (SizeType i0 = 0;i0<observe_.size();i0++) {
-			if (!preOperator.isValid(i0+1)) continue;
-
-			OperatorType opA = preOperator(i0+1);
+			if (!values.valid(i0)) continue;
 
-			preOperator.printMatrix(opA.data,preOperator.siteDependent(),i0);
+			if (i0==0)
+				preOperator.printMatrix(preOperator(1).data,preOperator.siteDependent(),0);
 
-			if (i0==0) {
+			if (i0==0 && text) {
 				std::cout<<"site <"<<bra<<"|"<<preOperator.label();
 				std::cout<<"|"<<ket<<"> time\n";
 			}
 
-			observe_.setBrakets(bra,ket);
-			observe_.setPointer(threadId,i0);
+			RealType time = values.time(i0);
+			if (values.hasHook(i0)) {
+				output_.push(0, values.hook(i0), time);
+				if (text) {
+					std::cout<<"\n";
+					std::cout<<"0 "<<values.hook(i0);
+					std::cout<<" "<<time<<"\n";
+				}
+			}
 
-			SizeType tmp = density.size();
-			onePointHookForZero(i0,opA,"gs",threadId,density);
-			SizeType lastOne = density.size();
-			if (tmp != density.size() && lastOne > 0) {
-				lastOne--;
-				std::cout<<"0 "<<density[lastOne];
-				std::cout<<" "<<observe_.time(threadId)<<"\n";
+			output_.push(values.site(i0), values.value(i0), time);
+			if (text) {
+				std::cout<<values.site(i0)<<" "<<values.value(i0);
+				std::cout<<" "<<time<<"\n";
 			}
 
-			FieldType tmp1 = observe_.template
-			        onePoint<ApplyOperatorType>(i0,opA,ApplyOperatorType::BORDER_NO);
-			std::cout<<observe_.site(threadId)<<" "<<tmp1;
-			std::cout<<" "<<observe_.time(threadId)<<"\n";
-			density.push_back(tmp1);
-
-			if (!observe_.isAtCorner(numberOfSites_,threadId)) continue;
-
-			// also calculate next or prev. site:
-			SizeType x = (observe_.site(threadId)==1) ? 0 : numberOfSites_-1;
-
-			// operator might be site dependent
-			if (!preOperator.isValid(x)) continue;
-			OperatorType opAcorner = preOperator(x);
-
-			// do the corner case
-			observe_.setBrakets(bra,ket);
-			tmp1 = observe_.template
-			        onePoint<ApplyOperatorType>(i0,
-			                                    opAcorner,
-			                                    ApplyOperatorType::BORDER_YES);
-			std::cout<<x<<" "<<tmp1;
-			std::cout<<" "<<observe_.time(threadId)<<"\n";
-			density.push_back(tmp1);
+			// also the next or prev. site, if valid
+			if (!values.hasCorner(i0)) continue;
+
+			SizeType x = values.cornerSite(i0);
+			output_.push(x, values.corner(i0), time);
+			if (text) {
+				std::cout<<x<<" "<<values.corner(i0);
+				std::cout<<" "<<time<<"\n";
+			}
 		}
+
+		output_.end();
 	}
 
 	MatrixType SliceOrbital(const MatrixType& m,
@@ -332,6 +441,8 @@ private:
 
 					PsimagLite::String str = "<gs|n?" + ttos(i) + ";n?" + ttos(j) + "|gs>";
 					observe_.twoPoint(out,n1,n2,fermionicSign);
+					output_.matrix(str, observe_.time(0), out);
+					if (!output_.text()) continue;
 					std::cout << str << std::endl;
 					std::cout << out;
 				}
@@ -343,7 +454,7 @@ private:
 			SizeType counter = 0;
 			for (SizeType i = 0; i < orbitals; ++i) {
 				for (SizeType j = i; j < orbitals; ++j) {
-					PsimagLite::String str = "<gs|z?" + ttos(i) + ";z?" + ttos(j) + "|gs>";
+					PsimagLite::String str = orbitalsBraket("z", i, "z", j);
 					BraketType braket(model_,str);
 					manyPoint(&szsz_[counter],braket,rows,cols);
 					MatrixType tSzThis = szsz_[counter];
@@ -353,7 +464,7 @@ private:
 					else
 						tSzTotal +=  factor*tSzThis;
 
-					if (PsimagLite::Concurrency::root()) {
+					if (PsimagLite::Concurrency::root() && output_.text()) {
 						std::cout<<"OperatorSz orb"<<i<<"-"<<j<<":\n";
 						std::cout<<tSzThis;
 					}
@@ -361,7 +472,10 @@ private:
 				}
 			}
 
-			if (PsimagLite::Concurrency::root() && orbitals > 1) {
+			if (orbitals > 1)
+				output_.matrix("OperatorSz tot", observe_.time(0), tSzTotal);
+
+			if (PsimagLite::Concurrency::root() && orbitals > 1 && output_.text()) {
 				std::cout<<"OperatorSz tot:\n";
 				std::cout<<tSzTotal;
 			}
@@ -373,7 +487,7 @@ private:
 			SizeType counter = 0;
 			for (SizeType i = 0; i < orbitals; ++i) {
 				for (SizeType j = i; j < orbitals; ++j) {
-					PsimagLite::String str = "<gs|splus?" + ttos(i) + ";sminus?" + ttos(j) + "|gs>";
+					PsimagLite::String str = orbitalsBraket("splus", i, "sminus", j);
 					BraketType braket(model_,str);
 					manyPoint(&sPlusSminus_[counter],braket,rows,cols);
 					MatrixType tSpThis = sPlusSminus_[counter];
@@ -384,7 +498,7 @@ private:
 						tSpTotal +=  factor*tSpThis;
 
 					
-					if (PsimagLite::Concurrency::root()) {
+					if (PsimagLite::Concurrency::root() && output_.text()) {
 						std::cout<<"OperatorS+S- orb"<<i<<"-"<<j<<":\n";
 						std::cout<<tSpTotal;
 					}
@@ -392,7 +506,10 @@ private:
 				}
 			}
 
-			if (PsimagLite::Concurrency::root() && orbitals > 1) {
+			if (orbitals > 1)
+				output_.matrix("OperatorS+S- tot", observe_.time(0), tSpTotal);
+
+			if (PsimagLite::Concurrency::root() && orbitals > 1 && output_.text()) {
 				std::cout<<"OperatorS+S- tot:\n";
 				std::cout<<tSpTotal;
 			}
@@ -404,7 +521,7 @@ private:
 			SizeType counter = 0;
 			for (SizeType i = 0; i < orbitals; ++i) {
 				for (SizeType j = i; j < orbitals; ++j) {
-					PsimagLite::String str = "<gs|sminus?" + ttos(i) + ";splus?" + ttos(j) + "|gs>";
+					PsimagLite::String str = orbitalsBraket("sminus", i, "splus", j);
 					BraketType braket(model_,str);
 					manyPoint(&sMinusSplus_[counter],braket,rows,cols);
 					MatrixType tSmThis = sMinusSplus_[counter];
@@ -415,7 +532,7 @@ private:
 						tSmTotal +=  factor*tSmThis;
 
 
-					if (PsimagLite::Concurrency::root()) {
+					if (PsimagLite::Concurrency::root() && output_.text()) {
 						std::cout<<"OperatorS-S+ orb"<<i<<"-"<<j<<":\n";
 						std::cout<<tSmTotal;
 					}
@@ -423,7 +540,10 @@ private:
 				}
 			}
 
-			if (PsimagLite::Concurrency::root() && orbitals > 1) {
+			if (orbitals > 1)
+				output_.matrix("OperatorS-S+ tot", observe_.time(0), tSmTotal);
+
+			if (PsimagLite::Concurrency::root() && orbitals > 1 && output_.text()) {
 				std::cout<<"OperatorS-S+ tot:\n";
 				std::cout<<tSmTotal;
 			}
@@ -457,7 +577,11 @@ private:
 						spinTotalTotal +=  factor*spinTotal;
 
 				
-					if (PsimagLite::Concurrency::root()) {
+					output_.matrix("SpinTotal orb" + ttos(x) + "-" + ttos(y),
+					               observe_.time(0),
+					               spinTotal);
+
+					if (PsimagLite::Concurrency::root() && output_.text()) {
 							std::cout<<"SpinTotal orb"<<x<<"-"<<y<<":\n";
 							std::cout<<spinTotal;
 					}
@@ -465,7 +589,10 @@ private:
 				}	
 			}
 
-			if (PsimagLite::Concurrency::root() && orbitals > 1) {
+			if (orbitals > 1)
+				output_.matrix("SpinTotalTotal", observe_.time(0), spinTotalTotal);
+
+			if (PsimagLite::Concurrency::root() && orbitals > 1 && output_.text()) {
 				std::cout<<"SpinTotalTotal:\n";
 				std::cout<<spinTotalTotal;
 			}
@@ -668,8 +795,6 @@ private:
 
 		typedef typename ObserverType::Parallel4PointDsType Parallel4PointDsType;
 		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
-
 		Parallel4PointDsType helper4PointDs(m,
 		                                    observe_.fourpoint(),
 		                                    model_,
@@ -677,6 +802,8 @@ private:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_THINupdn);
 
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threaded4PointDs(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
 		threaded4PointDs.loopCreate(helper4PointDs);
 
 		MatrixType mup(rows,cols);
@@ -1130,8 +1257,6 @@ private:
 
 		typedef typename ObserverType::Parallel4PointDsType Parallel4PointDsType;
 		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
-
 		Parallel4PointDsType helper4PointDs(m,
 		                                    observe_.fourpoint(),
 		                                    model_,
@@ -1139,6 +1264,8 @@ private:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_THIN);
 
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threaded4PointDs(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
 		threaded4PointDs.loopCreate(helper4PointDs);
 
 		MatrixType mTriplet(rows,cols);
@@ -1234,16 +1361,29 @@ private:
 	               SizeType rows,
 	               SizeType cols)
 	{
-		if (hasTimeEvolution_) {
-			SizeType threadId = 0;
+		SizeType threadId = 0;
+		bool text = output_.text();
+		if (hasTimeEvolution_ && text) {
 			printSites(threadId);
 			std::cout<<"Time="<<observe_.time(threadId)<<"\n";
+		} else if (hasTimeEvolution_ && observe_.size() > 0) {
+			observe_.setPointer(threadId, observe_.size() - 1); // as printSites() does
 		}
 
-		std::cout<<braket.toString()<<"\n";
+		if (text) std::cout<<braket.toString()<<"\n";
 		observe_.setBrakets(braket.bra(), braket.ket());
 
 		if (braket.points() == 2) {
+			typename MapStringMatrixType::const_iterator it = fused_.find(braket.toString());
+			if (it != fused_.end()) {
+				output_.matrix(braket.toString(), observe_.time(threadId), it->second);
+				if (storage)
+					*storage = it->second;
+				else if (text)
+					std::cout<<it->second;
+				return;
+			}
+
 			bool needsPrinting = false;
 			if (storage == 0) {
 				needsPrinting = true;
@@ -1251,9 +1391,10 @@ private:
 			}
 
 			observe_.twoPoint(*storage,braket);
+			output_.matrix(braket.toString(), observe_.time(threadId), *storage);
 
 			if (needsPrinting) {
-				std::cout<<(*storage);
+				if (text) std::cout<<(*storage);
 				delete storage;
 				storage = 0;
 			}
@@ -1262,13 +1403,13 @@ private:
 		}
 
 		if (braket.points() == 3)
-			return observe_.threePoint(braket,rows,cols);
+			return observe_.threePoint(braket,rows,cols,output_);
 
 
 		if (braket.points() == 4)
-			return observe_.fourPoint(braket,rows,cols);
+			return observe_.fourPoint(braket,rows,cols,output_);
 
-		observe_.anyPoint(braket);
+		observe_.anyPoint(braket,output_);
 	}
 
 	void measureTime(const PsimagLite::String& label)
@@ -1330,73 +1471,68 @@ private:
 	void measureOnePoint(const PreOperatorBaseType& preOperator)
 	{
 		const PsimagLite::String& modelName = model_.params().model;
-		SizeType threadId = preOperator.threadId();
-		VectorFieldType density;
+		bool text = output_.text();
 
-		for (SizeType i0 = 0;i0<observe_.size();i0++) {
-			if (!preOperator.isValid(i0+1)) continue;
+		// for g.s. use this one:
+		observe_.setBrakets("gs","gs");
+		Parallel1PointType gs(observe_, preOperator, numberOfSites_, !hasTimeEvolution_);
+		observe_.onePoint(gs);
 
-			OperatorType opA = preOperator(i0+1);
-			FieldType tmp1;
+		// for time vector use this one:
+		Parallel1PointType timeVector(observe_, preOperator, numberOfSites_, false);
+		if (hasTimeEvolution_) {
+			observe_.setBrakets("time","time");
+			observe_.onePoint(timeVector);
+			output_.begin(preOperator.label() + "(timevector)", 0.0, 1);
+		}
 
-			preOperator.printMatrix(opA.data,preOperator.siteDependent(),i0);
+		VectorFieldType density;
+		for (SizeType i0 = 0;i0<observe_.size();i0++) {
+			if (!gs.valid(i0)) continue;
 
-			if (i0==0) {
+			if (i0==0)
+				preOperator.printMatrix(preOperator(1).data,preOperator.siteDependent(),0);
+
+			if (i0==0 && text) {
 				std::cout<<"site "<<preOperator.label()<<"(gs) ";
 				if (hasTimeEvolution_)
 					std::cout<<preOperator.label()<<"(timevector) time";
 				//std::cout<<"\n";
 			}
-			// for g.s. use this one:
-			observe_.setBrakets("gs","gs");
-			observe_.setPointer(threadId,i0);
 
-			onePointHookForZero(i0,opA,"gs",threadId, density);
+			if (gs.hasHook(i0)) {
+				density.push_back(gs.hook(i0));
+				if (text) std::cout<<"\n";
+			}
 
-			tmp1 = observe_.template
-			        onePoint<ApplyOperatorType>(i0,opA,ApplyOperatorType::BORDER_NO);
-			density.push_back(tmp1);
+			density.push_back(gs.value(i0));
 
-			if (hasTimeEvolution_) { // for time vector use this one:
-				observe_.setBrakets("time","time");
+			if (hasTimeEvolution_) {
+				output_.push(timeVector.site(i0), timeVector.value(i0), timeVector.time(i0));
+				if (text) std::cout<<" "<<timeVector.value(i0)<<" "<<timeVector.time(i0);
+			}
 
-				onePointHookForZero(i0,opA,"time",threadId,density);
+			// also the next or prev. site, if valid
+			if (!gs.hasCorner(i0)) continue;
 
-				FieldType tmp2 = observe_.template
-				        onePoint<ApplyOperatorType>(i0,opA,ApplyOperatorType::BORDER_NO);
+			density.push_back(gs.corner(i0));
 
-				std::cout<<" "<<tmp2<<" "<<observe_.time(threadId);
+			if (hasTimeEvolution_) {
+				output_.push(timeVector.cornerSite(i0),
+				             timeVector.corner(i0),
+				             timeVector.time(i0));
+				if (text) std::cout<<" "<<timeVector.corner(i0)<<" "<<timeVector.time(i0);
 			}
+		}
 
-			// also calculate next or prev. site:
-			if (observe_.isAtCorner(numberOfSites_,threadId)) {
-				SizeType x = (observe_.site(threadId)==1) ? 0 : numberOfSites_-1;
-
-				// operator might be site dependent
-				if (!preOperator.isValid(x)) continue;
-				OperatorType opAcorner = preOperator(x);
-
-				// do the corner case
-				// for g.s. use this one:
-				observe_.setBrakets("gs","gs");
-				FieldType tmp1 = observe_.template
-				        onePoint<ApplyOperatorType>(i0,
-				                                    opAcorner,
-				                                    ApplyOperatorType::BORDER_YES);
-				density.push_back(tmp1);
-
-				if (hasTimeEvolution_) {// for time vector use this one:
-					observe_.setBrakets("time","time");
-					FieldType tmp2 = observe_.template
-					        onePoint<ApplyOperatorType>(i0,
-					                                    opAcorner,
-					                                    ApplyOperatorType::BORDER_YES);
-					std::cout<<" "<<tmp2<<" "<<observe_.time(threadId);
-				}
+		if (hasTimeEvolution_) output_.end();
 
-				//std::cout<<"\n";
-			}
-		}
+		output_.begin(preOperator.label() + "(gs)", 0.0, 1);
+		for (SizeType i0 = 0; i0 < density.size(); ++i0)
+			output_.push(i0, density[i0]);
+		output_.end();
+
+		if (!text) return;
 
 		if (modelName=="HubbardOneBandExtendedSuper") {
 			SizeType nsite=observe_.size()/2+1;
@@ -1410,22 +1546,6 @@ private:
 		}
 	}
 
-	void onePointHookForZero(SizeType i0,
-	                         const OperatorType& opA,
-	                         const PsimagLite::String& gsOrTime,
-	                         SizeType threadId,
-	                         VectorFieldType& density)
-	{
-		if (hasTimeEvolution_) return;
-		if (observe_.site(threadId)!=1 || observe_.isAtCorner(numberOfSites_,threadId))
-			return;
-		assert(observe_.site(threadId)==1);
-		FieldType tmp1 = observe_.template onePointHookForZero<ApplyOperatorType>(i0,opA);
-		density.push_back(tmp1);
-		if (hasTimeEvolution_ && gsOrTime=="time") std::cout<<"\n";
-		if (!hasTimeEvolution_) std::cout<<"\n";
-	}
-
 	SizeType logBase2(SizeType x) const
 	{
 		SizeType counter = 0;
@@ -1476,9 +1596,11 @@ private:
 	SizeType numberOfSites_;
 	bool hasTimeEvolution_;
 	const ModelType& model_; // not the owner
+	ObserveOutputType& output_; // not the owner
 	ObserverType observe_;
 	OperatorType matrixNup_,matrixNdown_;
 	VectorMatrixType szsz_,sPlusSminus_,sMinusSplus_;
+	MapStringMatrixType fused_;
 
 }; // class ObservableLibrary
 
@@ -0,0 +1,176 @@
+#ifndef OBSERVEOUTPUT_H
+#define OBSERVEOUTPUT_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "TypeToString.h"
+#include "Io/IoSelector.h"
+#include "Utils.h"
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+/* PSIDOC ObserveOutput
+ With ObserveToIo in SolverOptions, or with -o ObserveToIo given to observe,
+ the observe driver also writes its results, as typed datasets, to a file
+ in the directory of OutputFile named Observe followed by the basename of
+ OutputFile (runs/x.hd5 gives runs/Observex.hd5), so that they can be read
+ without parsing the text.
+ Result n, for n=0,1,...,Observe/Size-1, is the group Observe/n, with
+ Label, the braket or observable as it appears in the text;
+ Time, the time of the time vector (zero for the ground state);
+ Points, the number of sites of each value;
+ Sites, the Points sites of each value one after the other; and Values.
+ One-point results of time vectors have Time zero, and Times, the time of
+ each value.
+ Matrices, like two-point correlations, have Points=2, Rows, Cols,
+ Values in row-major order, and no Sites.
+ With ObserveNoText the text output of the results written this way is omitted.
+ With MPI only the root rank prints results and writes the file.
+ */
+template<typename ComplexOrRealType>
+class ObserveOutput {
+
+public:
+
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::IoSelector::Out IoOutType;
+
+	ObserveOutput(PsimagLite::String filename, PsimagLite::String options)
+	    : ioOut_(0),
+	      text_(options.find("ObserveNoText") == PsimagLite::String::npos),
+	      root_(PsimagLite::Concurrency::root()),
+	      records_(0),
+	      time_(0),
+	      points_(0)
+	{
+		if (options.find("ObserveToIo") == PsimagLite::String::npos) {
+			if (!text_) err("ObserveNoText needs ObserveToIo\n");
+			return;
+		}
+
+		if (!root_) return;
+
+		ioOut_ = new IoOutType(utils::pathPrepend("Observe", filename),
+		                       PsimagLite::IoSelector::ACC_TRUNC);
+		ioOut_->createGroup("Observe");
+		ioOut_->write(records_, "Observe/Size");
+	}
+
+	~ObserveOutput()
+	{
+		close();
+	}
+
+	// Closes the file; later results are no longer written to it
+	void close()
+	{
+		if (!ioOut_) return;
+		ioOut_->close();
+		delete ioOut_;
+		ioOut_ = 0;
+	}
+
+	// true unless ObserveNoText was given, and false on non-root ranks
+	bool text() const { return (text_ && root_); }
+
+	// Starts a record of values of points sites each
+	void begin(PsimagLite::String label, RealType time, SizeType points)
+	{
+		label_ = label;
+		time_ = time;
+		points_ = points;
+		sites_.clear();
+		values_.clear();
+		times_.clear();
+	}
+
+	// sites must have the points of begin()
+	void push(const VectorSizeType& sites, const ComplexOrRealType& value)
+	{
+		if (!ioOut_) return;
+		assert(sites.size() == points_);
+		sites_.insert(sites_.end(), sites.begin(), sites.end());
+		values_.push_back(value);
+	}
+
+	void push(SizeType site, const ComplexOrRealType& value)
+	{
+		if (!ioOut_) return;
+		assert(points_ == 1);
+		sites_.push_back(site);
+		values_.push_back(value);
+	}
+
+	void push(SizeType site, const ComplexOrRealType& value, RealType time)
+	{
+		if (!ioOut_) return;
+		push(site, value);
+		times_.push_back(time);
+	}
+
+	void end()
+	{
+		if (!ioOut_) return;
+		write(0, 0);
+	}
+
+	void matrix(PsimagLite::String label, RealType time, const MatrixType& m)
+	{
+		if (!ioOut_) return;
+		begin(label, time, 2);
+		SizeType rows = m.n_row();
+		SizeType cols = m.n_col();
+		values_.resize(rows*cols);
+		for (SizeType i = 0; i < rows; ++i)
+			for (SizeType j = 0; j < cols; ++j)
+				values_[j + i*cols] = m(i, j);
+
+		write(rows, cols);
+	}
+
+private:
+
+	ObserveOutput(const ObserveOutput&);
+
+	ObserveOutput& operator=(const ObserveOutput&);
+
+	void write(SizeType rows, SizeType cols)
+	{
+		PsimagLite::String prefix("Observe/" + ttos(records_));
+		ioOut_->createGroup(prefix);
+		ioOut_->write(label_, prefix + "/Label");
+		ioOut_->write(time_, prefix + "/Time");
+		ioOut_->write(points_, prefix + "/Points");
+		if (rows*cols > 0) {
+			ioOut_->write(rows, prefix + "/Rows");
+			ioOut_->write(cols, prefix + "/Cols");
+		}
+
+		if (sites_.size() > 0)
+			ioOut_->write(sites_, prefix + "/Sites");
+		if (values_.size() > 0)
+			ioOut_->write(values_, prefix + "/Values");
+		if (times_.size() > 0)
+			ioOut_->write(times_, prefix + "/Times");
+
+		++records_;
+		ioOut_->write(records_, "Observe/Size", IoOutType::Serializer::ALLOW_OVERWRITE);
+	}
+
+	IoOutType* ioOut_;
+	bool text_;
+	bool root_;
+	SizeType records_;
+	PsimagLite::String label_;
+	RealType time_;
+	SizeType points_;
+	VectorSizeType sites_;
+	VectorType values_;
+	VectorRealType times_;
+}; // class ObserveOutput
+} // namespace Dmrg
+#endif // OBSERVEOUTPUT_H
@@ -86,10 +86,14 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffsets.h" // for operator*
 #include "VectorWithOffset.h" // for operator*
 #include "Parallel4PointDs.h"
+#include "ManyPointTuples.h"
+#include "ParallelManyPoint.h"
 #include "MultiPointCorrelations.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
 #include "Utils.h"
+#include "ObserveOutput.h"
+#include "NoNestedThreads.h"
 
 namespace Dmrg {
 
@@ -104,6 +108,9 @@ class Observer {
 	typedef typename ModelType_::BasisWithOperatorsType BasisWithOperatorsType;
 	typedef typename BasisWithOperatorsType::SparseMatrixType SparseMatrixType;
 	typedef typename ModelType_::ModelHelperType::LeftRightSuperType LeftRightSuperType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorFieldType;
 	typedef ObserverHelper<IoInputType,
 	MatrixType,
 	VectorType,
@@ -129,6 +136,10 @@ public:
 	typedef ModelType_ ModelType;
 	typedef VectorWithOffsetType_ VectorWithOffsetType;
 	typedef Parallel4PointDs<ModelType,FourPointCorrelationsType> Parallel4PointDsType;
+	typedef typename TwoPointCorrelationsType::Correlator TwoPointCorrelatorType;
+	typedef typename TwoPointCorrelationsType::VectorCorrelatorType VectorTwoPointCorrelatorType;
+	typedef ObserveOutput<FieldType> ObserveOutputType;
+	typedef ParallelManyPoint<FourPointCorrelationsType> ParallelManyPointType;
 
 	Observer(IoInputType& io,
 	         SizeType start,
@@ -237,9 +248,16 @@ public:
 		twopoint_(m, O1, O2, fermionicSign);
 	}
 
+	// All two-point correlators in one pass; the brakets must have been set
+	void twoPoint(const VectorTwoPointCorrelatorType& correlators)
+	{
+		twopoint_(correlators);
+	}
+
 	void threePoint(const BraketType& braket,
 	                SizeType rows,
-	                SizeType cols)
+	                SizeType cols,
+	                ObserveOutputType& output)
 	{
 		assert(braket.points() == 3);
 
@@ -266,58 +284,43 @@ public:
 		}
 
 		SizeType threadId = 0;
-
-		if (flag == 7) {
-			std::cout<<"Fixed all sites\n";
-			typename MatrixType::value_type tmp = fourpoint_.threePoint(braket.site(0),
-			                                                            braket.site(1),
-			                                                            braket.site(2),
-			                                                            braket,
-			                                                            threadId);
-			std::cout<<braket.site(0)<<" ";
-			std::cout<<braket.site(1)<<" "<<braket.site(2)<<"  "<<tmp<<"\n";
-			return;
-		}
-
-		if (flag == 1) {
-			SizeType site0 = braket.site(0);
-			std::cout<<"Fixed site0= "<<site0<<"\n";
-			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
-				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket,
-					                                                            threadId);
-					std::cout<<site1<<" "<<site2<<"  "<<tmp<<"\n";
-
-				}
+		VectorIntType fixed(3, -1);
+		for (SizeType i = 0; i < 3; ++i)
+			if (flag & (1 << i)) fixed[i] = braket.site(i);
+
+		VectorSizeType bounds(3, rows);
+		bounds[2] = cols;
+		ManyPointTuples tuples(fixed, bounds);
+
+		VectorFieldType values;
+		manyPointValues(values, braket, tuples);
+
+		bool text = output.text();
+		if (text && flag == 7) std::cout<<"Fixed all sites\n";
+		if (text && flag == 1) std::cout<<"Fixed site0= "<<braket.site(0)<<"\n";
+
+		output.begin(braket.toString(), time(threadId), 3);
+		VectorSizeType tuple(3, 0);
+		tuples.first(tuple);
+		for (SizeType t = 0; t < values.size(); ++t) {
+			output.push(tuple, values[t]);
+			if (text) {
+				if (flag != 1) std::cout<<tuple[0]<<" ";
+				std::cout<<tuple[1]<<" "<<tuple[2]<<"  "<<values[t]<<"\n";
 			}
 
-			return;
+			tuples.next(tuple);
 		}
 
-		assert(flag == 0);
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
-			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
-				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket,
-					                                                            threadId);
-					std::cout<<site0<<" "<<site1<<" "<<site2<<"  "<<tmp<<"\n";
-				}
-			}
-		}
+		output.end();
 	}
 
 	const FourPointCorrelationsType& fourpoint() const {return fourpoint_; }
 
 	void fourPoint(const BraketType& braket,
 	               SizeType rows,
-	               SizeType cols)
+	               SizeType cols,
+	               ObserveOutputType& output)
 	{
 		assert(braket.points() == 4);
 
@@ -349,79 +352,42 @@ public:
 		}
 
 		SizeType threadId = 0;
-
-		if (flag == 15) {
-			std::cout<<"Fixed all sites\n";
-			SizeType site0 = braket.site(0);
-			SizeType site1 = braket.site(1);
-			typename FourPointCorrelationsType::SparseMatrixType O2gt;
-			fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1,threadId);
-			typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-			                                                             site1,
-			                                                             'N',braket.site(2),
-			                                                             'N',braket.site(3),
-			                                                             braket,
-			                                                             2,
-			                                                             3,
-			                                                             threadId);
-			std::cout<<site0<<" "<<site1<<" ";
-			std::cout<<braket.site(2)<<" "<<braket.site(3)<<"  "<<tmp<<"\n";
-			return;
+		VectorIntType fixed(4, -1);
+		for (SizeType i = 0; i < 4; ++i)
+			if (flag & (1 << i)) fixed[i] = braket.site(i);
+
+		VectorSizeType bounds(4, rows);
+		bounds[1] = bounds[3] = cols;
+		ManyPointTuples tuples(fixed, bounds);
+
+		VectorFieldType values;
+		manyPointValues(values, braket, tuples);
+
+		bool text = output.text();
+		if (text && flag == 15) std::cout<<"Fixed all sites\n";
+		if (text && flag == 3) {
+			std::cout<<"Fixed site0= "<<braket.site(0)<<"\n";
+			std::cout<<"Fixed site1= "<<braket.site(1)<<"\n";
 		}
 
-		if (flag == 3) {
-			SizeType site0 = braket.site(0);
-			SizeType site1 = braket.site(1);
-			std::cout<<"Fixed site0= "<<site0<<"\n";
-			std::cout<<"Fixed site1= "<<site1<<"\n";
-			typename FourPointCorrelationsType::SparseMatrixType O2gt;
-			fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1,threadId);
-
-			for (SizeType site2 = site1+1; site2 < rows; ++site2) {
-				for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-					typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-					                                                             site1,
-					                                                             'N',
-					                                                             site2,
-					                                                             'N',
-					                                                             site3,
-					                                                             braket,
-					                                                             2,
-					                                                             3,
-					                                                             threadId);
-					std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
-				}
+		output.begin(braket.toString(), time(threadId), 4);
+		VectorSizeType tuple(4, 0);
+		tuples.first(tuple);
+		for (SizeType t = 0; t < values.size(); ++t) {
+			output.push(tuple, values[t]);
+			if (text) {
+				if (flag != 3) std::cout<<tuple[0]<<" "<<tuple[1]<<" ";
+				std::cout<<tuple[2]<<" "<<tuple[3]<<((flag == 15) ? "  " : " ");
+				std::cout<<values[t]<<"\n";
 			}
 
-			return;
+			tuples.next(tuple);
 		}
 
-		assert(flag == 0);
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
-			for (SizeType site1 = site0+1; site1 < cols; ++site1) {
-				for (SizeType site2 = site1+1; site2 < rows; ++site2) {
-					for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-						typename FourPointCorrelationsType::SparseMatrixType O2gt;
-						fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1,threadId);
-						typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-						                                                             site1,
-						                                                             'N',
-						                                                             site2,
-						                                                             'N',
-						                                                             site3,
-						                                                             braket,
-						                                                             2,
-						                                                             3,
-						                                                             threadId);
-						std::cout<<site0<<" "<<site1<<" ";
-						std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
-					}
-				}
-			}
-		}
+		output.end();
 	}
 
-	void anyPoint(const BraketType& braket)
+	void anyPoint(const BraketType& braket, ObserveOutputType& output)
 	{
 		assert(braket.points() >= 4);
 
@@ -457,9 +423,20 @@ public:
 		FieldType tmp = fourpoint_.anyPoint(braket,
 		                                    threadId);
 
+		SizeType points = braket.points();
+		VectorSizeType sites(points, 0);
+		for (SizeType i = 0; i < points; ++i)
+			sites[i] = braket.site(i);
+
+		output.begin(braket.toString(), time(threadId), points);
+		output.push(sites, tmp);
+		output.end();
+
+		if (!output.text()) return;
+
 		std::cout<<"Fixed all sites\n";
-		for (SizeType i = 0; i < braket.points(); ++i)
-			std::cout<<braket.site(i)<<" ";
+		for (SizeType i = 0; i < points; ++i)
+			std::cout<<sites[i]<<" ";
 
 		std::cout<<tmp<<"\n";
 	}
@@ -500,8 +477,6 @@ public:
 
 
 		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
-
 		Parallel4PointDsType helper4PointDs(fpd,
 		                                    fourpoint_,
 		                                    model,
@@ -509,23 +484,38 @@ public:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_NORMAL);
 
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threaded4PointDs(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
 		threaded4PointDs.loopCreate(helper4PointDs);
 	}
 
 	template<typename ApplyOperatorType>
 	FieldType onePoint(SizeType site,
 	                   const typename ApplyOperatorType::OperatorType& A,
-	                   typename ApplyOperatorType::BorderEnum corner)
+	                   typename ApplyOperatorType::BorderEnum corner,
+	                   SizeType threadId = 0)
 	{
-		return onepoint_.template operator()<ApplyOperatorType>(site,A,corner);
+		return onepoint_.template operator()<ApplyOperatorType>(site,A,corner,threadId);
 	}
 
 	template<typename ApplyOperatorType>
 	FieldType onePointHookForZero(SizeType site,
 	                              const typename ApplyOperatorType::OperatorType& A,
-	                              bool corner = false)
+	                              bool corner = false,
+	                              SizeType threadId = 0)
 	{
-		return onepoint_.template hookForZero<ApplyOperatorType>(site,A,corner);
+		return onepoint_.template hookForZero<ApplyOperatorType>(site,A,corner,threadId);
+	}
+
+	// One-point values at all positions, threaded over positions;
+	// see Parallel1PointCorrelations
+	template<typename SomeParallel1PointType>
+	void onePoint(SomeParallel1PointType& helper)
+	{
+		typedef PsimagLite::Parallelizer<SomeParallel1PointType> ParallelizerType;
+		ParallelizerType threaded1Point(PsimagLite::Concurrency::codeSectionParams);
+		threaded1Point.loopCreate(helper);
+		helper.sync();
 	}
 
 	template<typename VectorLikeType>
@@ -543,6 +533,19 @@ public:
 
 private:
 
+	// Values of braket at the tuples, threaded over chunks of tuples
+	void manyPointValues(VectorFieldType& values,
+	                     const BraketType& braket,
+	                     const ManyPointTuples& tuples) const
+	{
+		typedef PsimagLite::Parallelizer<ParallelManyPointType> ParallelizerType;
+		ParallelManyPointType helperManyPoint(values, fourpoint_, braket, tuples);
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threadedManyPoint(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
+		threadedManyPoint.loopCreate(helperManyPoint);
+		helperManyPoint.sync();
+	}
+
 	SizeType braketStringToNumber(const PsimagLite::String& str) const
 	{
 		if (str == "gs") return 0;
@@ -111,9 +111,9 @@ public:
 	template<typename ApplyOperatorType>
 	FieldType operator()(SizeType site,
 	                     const typename ApplyOperatorType::OperatorType& A,
-	                     typename ApplyOperatorType::BorderEnum corner)
+	                     typename ApplyOperatorType::BorderEnum corner,
+	                     SizeType threadId = 0)
 	{
-		SizeType threadId =0;
 		SizeType pnter=site;
 		helper_.setPointer(threadId,pnter);
 		try {
@@ -133,10 +133,10 @@ public:
 	template<typename ApplyOperatorType>
 	FieldType hookForZero(SizeType site,
 	                      const typename ApplyOperatorType::OperatorType& A,
-	                      bool corner = false)
+	                      bool corner = false,
+	                      SizeType threadId = 0)
 	{
 		SizeType pnter=site;
-		SizeType threadId = 0;
 		helper_.setPointer(threadId,pnter);
 		try {
 			const VectorWithOffsetType& src1 = helper_.getVectorFromBracketId(LEFT_BRAKET,
@@ -0,0 +1,143 @@
+#ifndef PARALLEL_1POINT_CORRELATIONS_H
+#define PARALLEL_1POINT_CORRELATIONS_H
+
+#include "Vector.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+/* One-point values of an operator at all positions of the observer
+
+   One task per position i0, done with the pointer of the thread that runs it.
+   value(i0) is the value of preOperator(i0 + 1) at the site of i0;
+   hook(i0) is the value at site 0, present if hookForZero and i0 is at
+   site 1 but not at a corner; and corner(i0) is the value at the site
+   next to the corner, present if i0 is at a corner.
+   With MPI, position i0 is computed by rank i0 % ranks and the values are
+   then summed over ranks; sites, times, and flags are found by all ranks.
+   The brakets of the observer must have been set.
+*/
+template<typename ObserverType, typename ApplyOperatorType, typename PreOperatorType>
+class Parallel1PointCorrelations {
+
+	typedef typename ObserverType::VectorWithOffsetType VectorWithOffsetType;
+	typedef typename VectorWithOffsetType::value_type FieldType;
+	typedef typename PsimagLite::Real<FieldType>::Type RealType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorFieldType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename ApplyOperatorType::OperatorType OperatorType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	enum {FLAG_VALID = 1, FLAG_HOOK = 2, FLAG_CORNER = 4};
+
+public:
+
+	Parallel1PointCorrelations(ObserverType& observe,
+	                           const PreOperatorType& preOperator,
+	                           SizeType numberOfSites,
+	                           bool hookForZero)
+	    : observe_(observe),
+	      preOperator_(preOperator),
+	      numberOfSites_(numberOfSites),
+	      hookForZero_(hookForZero),
+	      flags_(observe.size(), 0),
+	      site_(observe.size(), 0),
+	      cornerSite_(observe.size(), 0),
+	      time_(observe.size(), 0.0),
+	      value_(observe.size(), 0.0),
+	      hook_(observe.size(), 0.0),
+	      corner_(observe.size(), 0.0),
+	      mpiRank_(0),
+	      mpiSize_(1)
+	{
+		if (!ConcurrencyType::hasMpi() || ConcurrencyType::isMpiDisabled("Observer"))
+			return;
+
+		mpiRank_ = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+		mpiSize_ = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+	}
+
+	SizeType tasks() const { return flags_.size(); }
+
+	void doTask(SizeType i0, SizeType threadNum)
+	{
+		if (!preOperator_.isValid(i0 + 1)) return;
+
+		flags_[i0] = FLAG_VALID;
+		observe_.setPointer(threadNum, i0);
+		site_[i0] = observe_.site(threadNum);
+		time_[i0] = observe_.time(threadNum);
+		bool atCorner = observe_.isAtCorner(numberOfSites_, threadNum);
+		if (hookForZero_ && site_[i0] == 1 && !atCorner)
+			flags_[i0] |= FLAG_HOOK;
+
+		if (atCorner) {
+			cornerSite_[i0] = (site_[i0] == 1) ? 0 : numberOfSites_ - 1;
+			if (preOperator_.isValid(cornerSite_[i0]))
+				flags_[i0] |= FLAG_CORNER;
+		}
+
+		if (i0 % mpiSize_ != mpiRank_) return;
+
+		OperatorType opA = preOperator_(i0 + 1);
+		if (flags_[i0] & FLAG_HOOK)
+			hook_[i0] = observe_.template
+			        onePointHookForZero<ApplyOperatorType>(i0, opA, false, threadNum);
+
+		value_[i0] = observe_.template
+		        onePoint<ApplyOperatorType>(i0, opA, ApplyOperatorType::BORDER_NO, threadNum);
+
+		if (!(flags_[i0] & FLAG_CORNER)) return;
+
+		OperatorType opAcorner = preOperator_(cornerSite_[i0]);
+		corner_[i0] = observe_.template
+		        onePoint<ApplyOperatorType>(i0, opAcorner, ApplyOperatorType::BORDER_YES, threadNum);
+	}
+
+	void sync()
+	{
+		if (mpiSize_ == 1) return;
+		PsimagLite::MPI::allReduce(value_);
+		PsimagLite::MPI::allReduce(hook_);
+		PsimagLite::MPI::allReduce(corner_);
+	}
+
+	bool valid(SizeType i0) const { return (flags_[i0] & FLAG_VALID); }
+
+	bool hasHook(SizeType i0) const { return (flags_[i0] & FLAG_HOOK); }
+
+	bool hasCorner(SizeType i0) const { return (flags_[i0] & FLAG_CORNER); }
+
+	SizeType site(SizeType i0) const { return site_[i0]; }
+
+	SizeType cornerSite(SizeType i0) const { return cornerSite_[i0]; }
+
+	RealType time(SizeType i0) const { return time_[i0]; }
+
+	const FieldType& value(SizeType i0) const { return value_[i0]; }
+
+	const FieldType& hook(SizeType i0) const { return hook_[i0]; }
+
+	const FieldType& corner(SizeType i0) const { return corner_[i0]; }
+
+private:
+
+	ObserverType& observe_;
+	const PreOperatorType& preOperator_;
+	SizeType numberOfSites_;
+	bool hookForZero_;
+	VectorSizeType flags_;
+	VectorSizeType site_;
+	VectorSizeType cornerSite_;
+	VectorRealType time_;
+	VectorFieldType value_;
+	VectorFieldType hook_;
+	VectorFieldType corner_;
+	SizeType mpiRank_;
+	SizeType mpiSize_;
+}; // class Parallel1PointCorrelations
+} // namespace Dmrg
+
+#endif // PARALLEL_1POINT_CORRELATIONS_H
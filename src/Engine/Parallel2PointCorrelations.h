@@ -128,6 +128,40 @@ private:
 	const SparseMatrixType& O2_;
 	int fermionicSign_;
 }; // class Parallel2PointCorrelations
+
+// One task per row of the fused correlators, see TwoPointCorrelations
+template<typename TwoPointCorrelationsType>
+class Parallel2PointRows {
+
+	typedef typename TwoPointCorrelationsType::VectorCorrelatorType VectorCorrelatorType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+public:
+
+	Parallel2PointRows(TwoPointCorrelationsType& twopoint,
+	                   const VectorCorrelatorType& correlators,
+	                   const VectorSizeType& uniqueO1,
+	                   SizeType rows)
+	    : twopoint_(twopoint),
+	      correlators_(correlators),
+	      uniqueO1_(uniqueO1),
+	      rows_(rows)
+	{}
+
+	void doTask(SizeType taskNumber ,SizeType threadNum)
+	{
+		twopoint_.calcRow(taskNumber,correlators_,uniqueO1_,threadNum);
+	}
+
+	SizeType tasks() const { return rows_; }
+
+private:
+
+	TwoPointCorrelationsType& twopoint_;
+	const VectorCorrelatorType& correlators_;
+	const VectorSizeType& uniqueO1_;
+	SizeType rows_;
+}; // class Parallel2PointRows
 } // namespace Dmrg 
 
 /*@}*/
@@ -82,6 +82,16 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 namespace Dmrg {
 
+/* Four-point values fpd(i,j) at a list of pairs (i,j)
+
+   Consecutive pairs with the same i are grouped in tiles, and each tile is
+   one task, so that a thread does the pairs of a tile in order: the first
+   stage, which depends only on i, is computed once per tile, and, with j
+   increasing, the growth of the first two operators continues from one
+   pair to the next (see the caches of FourPointCorrelations). Tiles are cut
+   to at most a quarter of the pairs per thread, so that long rows still
+   spread over the threads.
+*/
 template<typename ModelType,typename FourPointCorrelationsType>
 class Parallel4PointDs {
 
@@ -110,15 +120,44 @@ public:
 	      gammas_(gammas),
 	      pairs_(pairs),
 	      mode_(mode)
-	{}
+	{
+		SizeType n = pairs_.size();
+		if (n == 0) return;
+
+		SizeType threads = ConcurrencyType::codeSectionParams.npthreads;
+		SizeType maxTile = n/(4*threads);
+		if (maxTile == 0) maxTile = 1;
+
+		tiles_.push_back(0);
+		for (SizeType t = 1; t < n; ++t) {
+			bool full = (t - tiles_.back() >= maxTile);
+			if (full || pairs_[t].first != pairs_[t - 1].first)
+				tiles_.push_back(t);
+		}
+
+		tiles_.push_back(n);
+	}
 
 	void doTask(SizeType taskNumber, SizeType threadNum)
 	{
-		SizeType i = pairs_[taskNumber].first;
-		SizeType j = pairs_[taskNumber].second;
+		SizeType start = tiles_[taskNumber];
+		SizeType end = tiles_[taskNumber + 1];
+		for (SizeType t = start; t < end; ++t)
+			doPair(t, threadNum);
+	}
+
+	SizeType tasks() const
+	{
+		return (tiles_.size() == 0) ? 0 : tiles_.size() - 1;
+	}
+
+private:
+
+	void doPair(SizeType t, SizeType threadNum)
+	{
+		SizeType i = pairs_[t].first;
+		SizeType j = pairs_[t].second;
 
-		fpd_(i,j) = (mode_ == MODE_NORMAL) ? fourPointDelta(2*i,2*j,gammas_,model_,threadNum)
-		                                   : fourPointThin(i,j,gammas_,model_,threadNum);
 		if (mode_ == MODE_NORMAL) {
 			fpd_(i,j) = fourPointDelta(2*i,2*j,gammas_,model_,threadNum);
 		} else if (mode_ == MODE_THIN) {
@@ -130,10 +169,6 @@ public:
 		}
 	}
 
-	SizeType tasks() const { return pairs_.size(); }
-
-private:
-
 	template<typename SomeModelType>
 	FieldType fourPointDelta(SizeType i,
 	                         SizeType j,
@@ -265,6 +300,7 @@ private:
 	const typename PsimagLite::Vector<SizeType>::Type& gammas_;
 	const typename PsimagLite::Vector<PairType>::Type& pairs_;
 	FourPointModeEnum mode_;
+	typename PsimagLite::Vector<SizeType>::Type tiles_;
 }; // class Parallel4PointDs
 } // namespace Dmrg
 
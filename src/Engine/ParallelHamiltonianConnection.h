@@ -2,6 +2,7 @@
 #define PARALLELHAMILTONIANCONNECTION_H
 #include "Concurrency.h"
 #include "Vector.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
@@ -38,6 +39,7 @@ public:
 			const SparseMatrixType& hamiltonian = hc_.modelHelper().leftRightSuper().
 			        left().hamiltonian();
 			hc_.kroneckerDumper().push(true, hamiltonian, y_);
+			count(hamiltonian, threadNum);
 			return;
 		}
 
@@ -46,6 +48,7 @@ public:
 			const SparseMatrixType& hamiltonian = hc_.modelHelper().leftRightSuper().
 			        right().hamiltonian();
 			hc_.kroneckerDumper().push(false, hamiltonian, y_);
+			count(hamiltonian, threadNum);
 			return;
 		}
 
@@ -55,8 +58,13 @@ public:
 		SparseMatrixType const* A = 0;
 		SparseMatrixType const* B = 0;
 		const LinkType& link2 = hc_.getKron(&A, &B, taskNumber);
-		hc_.modelHelper().fastOpProdInter(xtemp_[threadNum], y_, *A, *B, link2);
+		if (ModelHelperType::isSu2())
+			hc_.modelHelper().linkProduct(xtemp_[threadNum], y_, hc_.linkKernel(taskNumber));
+		else
+			hc_.modelHelper().fastOpProdInter(xtemp_[threadNum], y_, *A, *B, link2);
+
 		hc_.kroneckerDumper().push(*A, *B, link2.value, link2.fermionOrBoson, y_);
+		count(*A, *B, threadNum);
 	}
 
 	SizeType tasks() const { return hc_.tasks() + 2; }
@@ -88,6 +96,36 @@ public:
 
 private:
 
+	// Estimated flops and bytes of x += (H_L or H_R)*y for this partition
+	void count(const SparseMatrixType& hamiltonian, SizeType threadNum) const
+	{
+		if (!Instrumentation::enabled()) return;
+		SizeType rows = hamiltonian.rows();
+		SizeType perRow = (rows > 0) ? hamiltonian.nonZeros()/rows : 0;
+		SizeType total = x_.size();
+		Instrumentation::addFlops(threadNum, 2*perRow*total);
+		Instrumentation::addBytes(threadNum,
+		                          hamiltonian.nonZeros()*(sizeof(ComplexOrRealType) +
+		                                                  sizeof(int)) +
+		                          (perRow + 1)*total*sizeof(ComplexOrRealType));
+	}
+
+	// Estimated flops and bytes of x += (A x B)*y for this partition
+	void count(const SparseMatrixType& A,
+	           const SparseMatrixType& B,
+	           SizeType threadNum) const
+	{
+		if (!Instrumentation::enabled()) return;
+		SizeType perRowA = (A.rows() > 0) ? A.nonZeros()/A.rows() : 0;
+		SizeType perRowB = (B.rows() > 0) ? B.nonZeros()/B.rows() : 0;
+		SizeType total = x_.size();
+		Instrumentation::addFlops(threadNum, 3*perRowA*perRowB*total);
+		Instrumentation::addBytes(threadNum,
+		                          (A.nonZeros() + B.nonZeros())*(sizeof(ComplexOrRealType) +
+		                                                         sizeof(int)) +
+		                          (perRowA*perRowB + 1)*total*sizeof(ComplexOrRealType));
+	}
+
 	VectorType& x_;
 	const VectorType& y_;
 	const HamiltonianConnectionType& hc_;
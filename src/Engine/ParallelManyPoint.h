@@ -0,0 +1,156 @@
+#ifndef PARALLEL_MANY_POINT_H
+#define PARALLEL_MANY_POINT_H
+
+#include <algorithm>
+#include "Vector.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+#include "ManyPointTuples.h"
+
+namespace Dmrg {
+
+/* Three- or four-point values of a braket at the tuples of ManyPointTuples
+
+   values[t] is the value at tuple t, in the order of ManyPointTuples.
+   Consecutive tuples are grouped in chunks, and each chunk is one task;
+   only the first tuple of each chunk is stored, and the task generates
+   the rest. For four points the tuples of a chunk share their first two
+   sites, so that the first stage is computed once per chunk. Chunks are
+   also cut to at most a quarter of the tuples per thread, so that a long
+   run of tuples with the same first two sites still spreads over the
+   threads. With MPI, chunk c is computed by rank c % ranks and the values
+   are then summed over ranks.
+*/
+template<typename FourPointCorrelationsType>
+class ParallelManyPoint {
+
+	typedef typename FourPointCorrelationsType::BraketType BraketType;
+	typedef typename FourPointCorrelationsType::SparseMatrixType SparseMatrixType;
+	typedef typename FourPointCorrelationsType::MatrixType MatrixType;
+	typedef typename MatrixType::value_type FieldType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+public:
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorFieldType;
+
+	ParallelManyPoint(VectorFieldType& values,
+	                  const FourPointCorrelationsType& fourpoint,
+	                  const BraketType& braket,
+	                  const ManyPointTuples& tuples)
+	    : values_(values),
+	      fourpoint_(fourpoint),
+	      braket_(braket),
+	      tuples_(tuples),
+	      points_(braket.points()),
+	      mpiRank_(0),
+	      mpiSize_(1)
+	{
+		assert(points_ == 3 || points_ == 4);
+		assert(tuples_.points() == points_);
+
+		if (ConcurrencyType::hasMpi() && !ConcurrencyType::isMpiDisabled("Observer")) {
+			mpiRank_ = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+			mpiSize_ = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		}
+
+		VectorSizeType tuple(points_, 0);
+		SizeType n = 0;
+		for (bool more = tuples_.first(tuple); more; more = tuples_.next(tuple))
+			++n;
+
+		values_.resize(n);
+		std::fill(values_.begin(), values_.end(), 0.0);
+		if (n == 0) return;
+
+		SizeType threads = ConcurrencyType::codeSectionParams.npthreads;
+		SizeType maxChunk = n/(4*threads*mpiSize_);
+		if (maxChunk == 0) maxChunk = 1;
+
+		VectorSizeType prev(points_, 0);
+		tuples_.first(tuple);
+		for (SizeType t = 0; t < n; ++t) {
+			bool full = (chunks_.size() == 0 || t - chunks_.back() >= maxChunk);
+			if (full || (points_ == 4 && !sameFirstTwo(prev, tuple))) {
+				chunks_.push_back(t);
+				starts_.insert(starts_.end(), tuple.begin(), tuple.end());
+			}
+
+			prev = tuple;
+			tuples_.next(tuple);
+		}
+
+		chunks_.push_back(n);
+	}
+
+	SizeType tasks() const
+	{
+		return (chunks_.size() == 0) ? 0 : chunks_.size() - 1;
+	}
+
+	void doTask(SizeType taskNumber, SizeType threadNum)
+	{
+		if (taskNumber % mpiSize_ != mpiRank_) return;
+
+		SizeType start = chunks_[taskNumber];
+		SizeType end = chunks_[taskNumber + 1];
+		VectorSizeType tuple(starts_.begin() + taskNumber*points_,
+		                     starts_.begin() + (taskNumber + 1)*points_);
+
+		if (points_ == 3) {
+			for (SizeType t = start; t < end; ++t) {
+				values_[t] = fourpoint_.threePoint(tuple[0],
+				                                   tuple[1],
+				                                   tuple[2],
+				                                   braket_,
+				                                   threadNum);
+				tuples_.next(tuple);
+			}
+
+			return;
+		}
+
+		SparseMatrixType O2gt;
+		fourpoint_.firstStage(O2gt,'N',tuple[0],'N',tuple[1],braket_,0,1,threadNum);
+		for (SizeType t = start; t < end; ++t) {
+			values_[t] = fourpoint_.secondStage(O2gt,
+			                                    tuple[1],
+			                                    'N',
+			                                    tuple[2],
+			                                    'N',
+			                                    tuple[3],
+			                                    braket_,
+			                                    2,
+			                                    3,
+			                                    threadNum);
+			tuples_.next(tuple, 2);
+		}
+	}
+
+	void sync()
+	{
+		if (mpiSize_ == 1) return;
+		PsimagLite::MPI::allReduce(values_);
+	}
+
+private:
+
+	static bool sameFirstTwo(const VectorSizeType& t1, const VectorSizeType& t2)
+	{
+		return (t1[0] == t2[0] && t1[1] == t2[1]);
+	}
+
+	VectorFieldType& values_;
+	const FourPointCorrelationsType& fourpoint_;
+	const BraketType& braket_;
+	const ManyPointTuples& tuples_;
+	SizeType points_;
+	SizeType mpiRank_;
+	SizeType mpiSize_;
+	VectorSizeType chunks_;
+	VectorSizeType starts_;
+}; // class ParallelManyPoint
+} // namespace Dmrg
+
+#endif // PARALLEL_MANY_POINT_H
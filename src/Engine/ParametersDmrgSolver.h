@@ -113,6 +113,10 @@ This file will be created if non-existent,
  and if it
 exits it will be truncated.
 
+\item[MemoryBudget=integer] Optional, defaults to 0, no budget.
+
+PSIDOCCOPY MemoryBudget
+
 \item[InfiniteLoopKeptStates=integer]  \emph{m} value for the infinite algorithm.
 
 \item[FiniteLoops=vector]
@@ -150,7 +154,9 @@ struct ParametersDmrgSolver {
 	SizeType dumperEnd;
 	SizeType precision;
 	SizeType recoveryMaxFiles;
+	SizeType memoryBudget;
 	int useReflectionSymmetry;
+	int long randomSeed;
 	bool autoRestart;
 	PairRealSizeType truncationControl;
 	PsimagLite::String filename;
@@ -191,6 +197,8 @@ struct ParametersDmrgSolver {
 		ioSerializer.write(root + "/fileForDensityMatrixEigs", fileForDensityMatrixEigs);
 		ioSerializer.write(root + "/recoverySave", recoverySave);
 		ioSerializer.write(root + "/recoveryMaxFiles", recoveryMaxFiles);
+		ioSerializer.write(root + "/memoryBudget", memoryBudget);
+		ioSerializer.write(root + "/randomSeed", randomSeed);
 		checkpoint.write(label + "/checkpoint", ioSerializer);
 		ioSerializer.write(root + "/adjustQuantumNumbers", adjustQuantumNumbers);
 		ioSerializer.write(root + "/finiteLoop", finiteLoop);
@@ -218,6 +226,8 @@ struct ParametersDmrgSolver {
 	      dumperEnd(0),
 	      precision(6),
 	      recoveryMaxFiles(3),
+	      memoryBudget(0),
+	      randomSeed(3433117),
 	      autoRestart(false),
 	      recoverySave("no"),
 	      adjustQuantumNumbers(0, QnType(false, VectorSizeType(), PairSizeType(0, 0), 0)),
@@ -359,6 +369,14 @@ struct ParametersDmrgSolver {
 			io.readline(denseSparseThreshold, "DenseSparseThreshold=");
 		} catch (std::exception&) {}
 
+		try {
+			io.readline(memoryBudget, "MemoryBudget=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(randomSeed, "RandomSeed=");
+		} catch (std::exception&) {}
+
 		if (isObserveCode) return;
 		bool hasRestart = false;
 		if (options.find("restart")!=PsimagLite::String::npos) {
@@ -533,6 +551,9 @@ struct ParametersDmrgSolver {
 
 		os<<"parameters.degeneracyMax="<<p.degeneracyMax<<"\n";
 		os<<"parameters.denseSparseThreshold="<<p.denseSparseThreshold<<"\n";
+		if (p.memoryBudget > 0)
+			os<<"parameters.memoryBudget="<<p.memoryBudget<<"\n";
+		os<<"parameters.randomSeed="<<p.randomSeed<<"\n";
 		os<<"parameters.nthreads="<<p.nthreads<<"\n";
 		os<<"parameters.useReflectionSymmetry="<<p.useReflectionSymmetry<<"\n";
 		os<<p.checkpoint;
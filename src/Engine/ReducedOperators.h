@@ -79,11 +79,14 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef REDUCEDOP_IMPL_H
 #define REDUCEDOP_IMPL_H
 
+#include <map>
 #include "Su2SymmetryGlobals.h"
 #include "Operator.h"
 #include "ChangeOfBasis.h"
 #include "BlockOffDiagMatrix.h"
 #include "../KronUtil/MatrixDenseOrSparse.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
 
 namespace Dmrg {
 template<typename BasisType>
@@ -105,6 +108,107 @@ class ReducedOperators {
 	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef ChangeOfBasis<SparseMatrixType, DenseMatrixType> ChangeOfBasisType;
+	typedef std::map<VectorSizeType, SparseElementType> MapCoefficientType;
+	typedef typename PsimagLite::Vector<MapCoefficientType>::Type VectorMapCoefficientType;
+
+	/* The lfactor table of one operator momentum k, one task per j value of
+	   basisA. Only the tuples of j values allowed by the triangle conditions
+	   of the four Clebsch-Gordan coefficients of calcLfactor are visited, the
+	   others are zero. A coefficient is taken from coefficients, or computed
+	   and then kept in newCoefficients of the thread, to be merged later.
+	*/
+	class ParallelLfactor {
+
+	public:
+
+		ParallelLfactor(VectorType& lfactor,
+		                const ReducedOperators& reduced,
+		                const MapCoefficientType& coefficients,
+		                bool order,
+		                const BasisType& basisA,
+		                const BasisType& basisB,
+		                SizeType k)
+		    : lfactor_(lfactor),
+		      reduced_(reduced),
+		      coefficients_(coefficients),
+		      order_(order),
+		      basisA_(basisA),
+		      basisB_(basisB),
+		      k_(k),
+		      newCoefficients_(PsimagLite::Concurrency::codeSectionParams.npthreads)
+		{}
+
+		SizeType tasks() const { return basisA_.jVals(); }
+
+		void doTask(SizeType i1, SizeType threadNum)
+		{
+			const BasisType& basisC = *(reduced_.thisBasis_);
+			VectorSizeType key(7, 0);
+			key[0] = (order_) ? 1 : 0;
+			key[1] = basisA_.jVals(i1);
+			key[6] = k_;
+			for (SizeType i2 = 0; i2 < basisB_.jVals(); ++i2) {
+				key[2] = basisB_.jVals(i2);
+				for (SizeType i1prime = 0; i1prime < basisA_.jVals(); ++i1prime) {
+					key[3] = basisA_.jVals(i1prime);
+					if (!reduced_.checkJvalues(key[3], key[1], k_)) continue;
+					for (SizeType i = 0; i < basisC.jVals(); ++i) {
+						key[4] = basisC.jVals(i);
+						if (!reduced_.checkJvalues(key[4], key[1], key[2])) continue;
+						for (SizeType iprime = 0; iprime < basisC.jVals(); ++iprime) {
+							key[5] = basisC.jVals(iprime);
+							if (!reduced_.checkJvalues(key[5], key[3], key[2])) continue;
+							if (!reduced_.checkJvalues(key[5], key[4], k_)) continue;
+							SizeType ix = reduced_.lfactorIndex(order_,
+							                                    key[1],
+							                                    key[2],
+							                                    key[3],
+							                                    key[4],
+							                                    key[5]);
+							lfactor_[ix] = coefficient(key, threadNum);
+						}
+					}
+				}
+			}
+		}
+
+		void sync(MapCoefficientType& coefficients) const
+		{
+			for (SizeType i = 0; i < newCoefficients_.size(); ++i)
+				coefficients.insert(newCoefficients_[i].begin(),
+				                    newCoefficients_[i].end());
+		}
+
+	private:
+
+		SparseElementType coefficient(const VectorSizeType& key, SizeType threadNum)
+		{
+			typename MapCoefficientType::const_iterator it = coefficients_.find(key);
+			if (it != coefficients_.end()) return it->second;
+
+			SparseElementType value = reduced_.calcLfactor(order_,
+			                                               key[1],
+			                                               key[2],
+			                                               key[3],
+			                                               key[4],
+			                                               key[5],
+			                                               k_);
+			assert(threadNum < newCoefficients_.size());
+			newCoefficients_[threadNum][key] = value;
+			return value;
+		}
+
+		VectorType& lfactor_;
+		const ReducedOperators& reduced_;
+		const MapCoefficientType& coefficients_;
+		bool order_;
+		const BasisType& basisA_;
+		const BasisType& basisB_;
+		SizeType k_;
+		VectorMapCoefficientType newCoefficients_;
+	}; // class ParallelLfactor
+
+	friend class ParallelLfactor;
 
 public:
 
@@ -241,20 +345,9 @@ public:
 		j1Max_=basis2.jMax();
 		j2Max_=basis3.jMax();
 
-		// build all lfactors
-		lfactorLeft_.resize(momentumOfOperators_.size());
-		for (SizeType i=0;i<momentumOfOperators_.size();i++) {
-			buildLfactor(lfactorLeft_[i],true,basis2,basis3,momentumOfOperators_[i]);
-		}
-
-		buildLfactor(lfactorHamLeft_,true,basis2,basis3,0);
-
-		lfactorRight_.resize(momentumOfOperators_.size());
-		for (SizeType i=0;i<momentumOfOperators_.size();i++) {
-			buildLfactor(lfactorRight_[i],false,basis2,basis3,momentumOfOperators_[i]);
-		}
-
-		buildLfactor(lfactorHamRight_,false,basis2,basis3,0);
+		// build all lfactors, once for each momentum
+		buildLfactors(lfactorLeft_,lfactorHamLeft_,true,basis2,basis3);
+		buildLfactors(lfactorRight_,lfactorHamRight_,false,basis2,basis3);
 		calcReducedMapping(basis2,basis3);
 		cacheFlavorIndex(basis2,basis3);
 		calcFastBasis(fastBasisLeft_,basis2,basis3,true,thisBasis_->reducedSize());
@@ -585,6 +678,32 @@ private:
 		}
 	}
 
+	void buildLfactors(VectorVectorType& lfactors,
+	                   VectorType& lfactorHam,
+	                   bool order,
+	                   const BasisType& basis2,
+	                   const BasisType& basis3)
+	{
+		buildLfactor(lfactorHam,order,basis2,basis3,0);
+
+		std::map<SizeType, SizeType> firstWithMomentum;
+		lfactors.resize(momentumOfOperators_.size());
+		for (SizeType i=0;i<momentumOfOperators_.size();i++) {
+			SizeType k = momentumOfOperators_[i];
+			std::map<SizeType, SizeType>::const_iterator it = firstWithMomentum.find(k);
+			if (it != firstWithMomentum.end()) {
+				lfactors[i] = lfactors[it->second];
+				continue;
+			}
+
+			if (k == 0) lfactors[i] = lfactorHam;
+			else buildLfactor(lfactors[i],order,basis2,basis3,k);
+			firstWithMomentum[k] = i;
+		}
+	}
+
+	// The coefficients depend only on the j values and k, so they are kept
+	// in lfactorCoefficients_ from one call to the next
 	void buildLfactor(VectorType& lfactor,
 	                  bool order,const BasisType& basis2,
 	                  const BasisType& basis3,
@@ -600,28 +719,19 @@ private:
 			basisB = &basis2;
 		}
 
-		lfactor.resize(j1Max_*j2Max_*jMax*thisBasis_->jMax()*thisBasis_->jMax());
-		for (SizeType i1=0;i1<basisA->jVals();i1++) {
-			for (SizeType i2=0;i2<basisB->jVals();i2++) {
-				for (SizeType i1prime=0;i1prime<basisA->jVals();i1prime++) {
-					for (SizeType i=0;i<thisBasis_->jVals();i++) {
-						for (SizeType iprime=0;iprime<thisBasis_->jVals();iprime++) {
-							SizeType ix = lfactorIndex(order,basisA->jVals(i1),
-							                           basisB->jVals(i2),
-							                           basisA->jVals(i1prime),
-							                           thisBasis_->jVals(i),
-							                           thisBasis_->jVals(iprime));
-
-							lfactor[ix]=calcLfactor(order,basisA->jVals(i1),
-							                        basisB->jVals(i2),
-							                        basisA->jVals(i1prime),
-							                        thisBasis_->jVals(i),
-							                        thisBasis_->jVals(iprime),k);
-						}
-					}
-				}
-			}
-		}
+		lfactor.assign(j1Max_*j2Max_*jMax*thisBasis_->jMax()*thisBasis_->jMax(), 0.0);
+
+		typedef PsimagLite::Parallelizer<ParallelLfactor> ParallelizerType;
+		ParallelizerType threadObject(PsimagLite::Concurrency::codeSectionParams);
+		ParallelLfactor helper(lfactor,
+		                       *this,
+		                       lfactorCoefficients_,
+		                       order,
+		                       *basisA,
+		                       *basisB,
+		                       k);
+		threadObject.loopCreate(helper);
+		helper.sync(lfactorCoefficients_);
 	}
 
 	SparseElementType calcLfactor(bool order,
@@ -919,7 +1029,7 @@ private:
 
 	const BasisType* thisBasis_;
 	bool useSu2Symmetry_;
-	ClebschGordanType* cgObject_;
+	const ClebschGordanType* cgObject_;
 	PsimagLite::Vector<SizeType>::Type momentumOfOperators_;
 	PsimagLite::Vector<SizeType>::Type basisrinverse_;
 	typename PsimagLite::Vector<OperatorType>::Type reducedOperators_;
@@ -929,6 +1039,7 @@ private:
 	VectorVectorType lfactorLeft_;
 	VectorVectorType lfactorRight_;
 	VectorType lfactorHamLeft_,lfactorHamRight_;
+	MapCoefficientType lfactorCoefficients_;
 	PsimagLite::Matrix<int> reducedMapping_;
 	PsimagLite::Vector<PsimagLite::Vector<SizeType>::Type>::Type fastBasisLeft_;
 	PsimagLite::Vector<PsimagLite::Vector<SizeType>::Type>::Type fastBasisRight_;
@@ -172,6 +172,16 @@ public:
 		return lfactor;
 	}
 
+	// The table that reducedFactor() reads, to be indexed by (lf1, lf2)
+	const PsimagLite::Matrix<SparseElementType>& reducedFactors(SizeType angularMomentum,
+	                                                            SizeType category,
+	                                                            bool flip) const
+	{
+		SizeType category2 = category;
+		if (flip) category2 = angularMomentum-category;
+		return lfactor_[category2];
+	}
+
 	SparseElementType reducedHamiltonianFactor(SizeType j1,SizeType j2) const
 	{
 		return lfactorHamiltonian_(j1,j2);
@@ -485,7 +495,7 @@ private:
 	typename PsimagLite::Vector<PairType>::Type reducedEffective_;
 	PsimagLite::Matrix<SizeType> reducedInverse_;
 	typename PsimagLite::Vector<SizeType>::Type flavorsOldInverse_;
-	ClebschGordanType& cgObject_;
+	const ClebschGordanType& cgObject_;
 }; // class
 } // namespace Dmrg
 /*@}*/
@@ -195,6 +195,11 @@ public:
 		return unimplemented("tau");
 	}
 
+	virtual RealType rungeKuttaTolerance() const
+	{
+		return 0;
+	}
+
 	virtual RealType maxTime() const
 	{
 		return unimplemented("maxTime");
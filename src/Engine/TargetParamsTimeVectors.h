@@ -100,7 +100,8 @@ public:
 	      advanceEach_(0),
 	      algorithm_(BaseType::KRYLOV),
 	      tau_(0),
-	      timeDirection_(1.0)
+	      timeDirection_(1.0),
+	      rungeKuttaTolerance_(0)
 	{
 		/*PSIDOC TargetParamsTimeVectors
 		\item[TSPTau] [RealType], $\tau$ for the Krylov,
@@ -112,6 +113,10 @@ public:
 		\item[TSPAlgorithm] [String] Either
 		\verb!Krylov! or \verb!RungeKutta! or \verb!SuzukiTrotter!\\
 		Note that SuzukiTrotter is currently very experimental and unsupported.
+		\item[TSPRungeKuttaTolerance] [RealType] Optional, only for RungeKutta.
+		If positive, each interval between times is integrated with adaptive
+		Dormand-Prince 5(4) steps whose error is below this tolerance, instead
+		of one RK4 step per interval.
 		*/
 		io.readline(tau_,"TSPTau=");
 		io.readline(timeSteps_,"TSPTimeSteps=");
@@ -136,6 +141,10 @@ public:
 		try {
 			io.readline(timeDirection_,"TSPTimeFactor=");
 		} catch (std::exception&) {}
+
+		try {
+			io.readline(rungeKuttaTolerance_,"TSPRungeKuttaTolerance=");
+		} catch (std::exception&) {}
 	}
 
 	virtual SizeType timeSteps() const
@@ -163,6 +172,11 @@ public:
 		return timeDirection_;
 	}
 
+	virtual RealType rungeKuttaTolerance() const
+	{
+		return rungeKuttaTolerance_;
+	}
+
 private:
 
 	SizeType timeSteps_;
@@ -170,6 +184,7 @@ private:
 	SizeType algorithm_;
 	RealType tau_;
 	RealType timeDirection_;
+	RealType rungeKuttaTolerance_;
 
 }; // class TargetParamsTimeVectors
 
@@ -183,6 +198,7 @@ operator<<(std::ostream& os,const TargetParamsTimeVectors<ModelType>& t)
 	os<<"TargetParams.advanceEach="<<t.advanceEach()<<"\n";
 	os<<"TargetParams.algorithm="<<t.algorithm()<<"\n";
 	os<<"TargetParams.timeDirection="<<t.timeDirection()<<"\n";
+	os<<"TargetParams.rungeKuttaTolerance="<<t.rungeKuttaTolerance()<<"\n";
 	return os;
 }
 } // namespace Dmrg
@@ -254,14 +254,14 @@ private:
 	{
 		VectorSizeType nk(1,this->model().hilbertSize(site));
 
+		// the wft keeps the quantum numbers, so result has the sectors of the
+		// source only
+		const VectorWithOffsetType& src = this->common().targetVectors()[i];
 		VectorWithOffsetType result;
-		result.populateSectors(this->lrs().super());
-
-		// OK, now that we got the partition number right, let's wft:
+		result.populateFromQns(src, this->lrs().super());
 
 		// FIXME generalize for su(2)
-		wft_.setInitialVector(result,this->common().targetVectors()[i],this->lrs(),nk);
-		result.collapseSectors();
+		wft_.setInitialVector(result,src,this->lrs(),nk);
 		this->common().targetVectors(i) = result;
 	}
 
@@ -753,8 +753,13 @@ private:
 		typename PsimagLite::Vector<bool>::Type oddElectrons;
 		targetHelper_.model().findOddElectronsOfOneSite(oddElectrons,site);
 		FermionSign fs(targetHelper_.lrs().left(), oddElectrons);
+		// only the sectors of src2 of A|src1> are needed
+		VectorSizeType wanted(src2.sectors());
+		for (SizeType jj = 0; jj < src2.sectors(); ++jj)
+			wanted[jj] = src2.sector(jj);
+
 		VectorWithOffsetType dest;
-		applyOpExpression_.applyOpLocal()(dest,src1,A,fs,systemOrEnviron,border);
+		applyOpExpression_.applyOpLocal()(dest,src1,A,fs,systemOrEnviron,border,wanted);
 
 		ComplexOrRealType sum = 0.0;
 		for (SizeType ii=0;ii<dest.sectors();ii++) {
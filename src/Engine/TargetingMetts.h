@@ -471,14 +471,13 @@ private:
 			msg<<"I'm calling the WFT now";
 			progress_.printline(msg,std::cout);
 
-			VectorWithOffsetType phiNew; // same sectors as g.s.
-			//phiNew.populateSectors(lrs_.super());
-			assert(norm(this->common().targetVectors()[advance])>1e-6);
-
-			phiNew.populateSectors(lrs_.super());
-			// OK, now that we got the partition number right, let's wft:
-			wft_.setInitialVector(phiNew,this->common().targetVectors()[advance],lrs_,nk);
-			phiNew.collapseSectors();
+			const VectorWithOffsetType& src = this->common().targetVectors()[advance];
+			assert(norm(src)>1e-6);
+
+			// the wft keeps the quantum numbers, so phiNew has the sectors of src only
+			VectorWithOffsetType phiNew;
+			phiNew.populateFromQns(src, lrs_.super());
+			wft_.setInitialVector(phiNew,src,lrs_,nk);
 			assert(norm(phiNew)>1e-6);
 			this->common().targetVectors(index) = phiNew;
 		} else {
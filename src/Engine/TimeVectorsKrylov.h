@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define TIME_VECTORS_KRYLOV
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "TimeVectorsBase.h"
 #include "ParallelTriDiag.h"
 #include "NoPthreadsNg.h"
@@ -270,12 +271,13 @@ private:
 	{
 		RealType timeDirection = tstStruct_.timeDirection();
 
+		// V^dagger phi, all Lanczos vectors against phi in one pass
+		TargetVectorType vTimesPhi;
+		calcVTimesPhi(vTimesPhi,V,phi,i0);
 		for (SizeType k=0;k<n2;k++) {
 			ComplexOrRealType sum = 0.0;
-			for (SizeType kprime=0;kprime<n2;kprime++) {
-				ComplexOrRealType tmpV = calcVTimesPhi(kprime,V,phi,i0);
-				sum += PsimagLite::conj(T(kprime,k))*tmpV;
-			}
+			for (SizeType kprime=0;kprime<n2;kprime++)
+				sum += PsimagLite::conj(T(kprime,k))*vTimesPhi[kprime];
 
 			RealType tmp = (eigs[k]-E0_)*times_[timeIndex]*timeDirection;
 			ComplexOrRealType c = 0.0;
@@ -284,17 +286,24 @@ private:
 		}
 	}
 
-	ComplexOrRealType calcVTimesPhi(SizeType kprime,
-	                                const MatrixComplexOrRealType& V,
-	                                const VectorWithOffsetType& phi,
-	                                SizeType i0) const
+	void calcVTimesPhi(TargetVectorType& ret,
+	                   const MatrixComplexOrRealType& V,
+	                   const VectorWithOffsetType& phi,
+	                   SizeType i0) const
 	{
-		ComplexOrRealType ret = 0;
 		SizeType total = phi.effectiveSize(i0);
+		SizeType cols = V.cols();
+		ret.resize(cols);
+		if (total == 0 || cols == 0) {
+			std::fill(ret.begin(), ret.end(), 0.0);
+			return;
+		}
 
-		for (SizeType j=0;j<total;j++)
-			ret += PsimagLite::conj(V(j,kprime))*phi.fastAccess(i0,j);
-		return ret;
+		assert(total <= V.rows());
+		ComplexOrRealType zone = 1.0;
+		ComplexOrRealType zzero = 0.0;
+		psimag::BLAS::GEMV('C',total,cols,zone,&(V(0,0)),V.rows(),
+		                   &(phi.fastAccess(i0,0)),1,zzero,&(ret[0]),1);
 	}
 
 	void triDiag(const VectorWithOffsetType& phi,
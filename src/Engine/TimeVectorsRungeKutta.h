@@ -80,8 +80,12 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef TIME_VECTORS_RUNGE_KUTTA
 #define TIME_VECTORS_RUNGE_KUTTA
 #include <iostream>
-#include "RungeKutta.h"
+#include <cmath>
 #include "TimeVectorsBase.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "Instrumentation.h"
+#include "NoNestedThreads.h"
 
 namespace Dmrg {
 
@@ -121,6 +125,8 @@ class TimeVectorsRungeKutta : public  TimeVectorsBase<
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef VectorComplexOrRealType TargetVectorType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorTargetVectorType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
 
 public:
 
@@ -144,9 +150,9 @@ public:
 	{}
 
 	virtual void calcTimeVectors(const PairType& startEnd,
-	                             RealType Eg,
+	                             RealType,
 	                             const VectorWithOffsetType& phi,
-	                             SizeType systemOrEnviron,
+	                             SizeType,
 	                             bool,
 	                             const PsimagLite::Vector<SizeType>::Type&)
 	{
@@ -161,14 +167,47 @@ public:
 		// set non-zero sectors
 		for (SizeType i=0;i<times_.size();i++) targetVectors_[i] = phi;
 
-		for (SizeType ii=0;ii<phi.sectors();ii++) {
-			SizeType i = phi.sector(ii);
-			calcTimeVectors(startEnd,Eg,phi,systemOrEnviron,i);
+		// With more than one sector, sectors go to the threads and each
+		// product is serial, and not timed, since timers belong to the master
+		// thread; otherwise the product is threaded
+		SizeType sectors = phi.sectors();
+		SizeType threads = ConcurrencyType::codeSectionParams.npthreads;
+		PsimagLite::CodeSectionParams sectorParams((sectors > 1) ? threads : 1);
+		ParallelRungeKutta helper(*this, phi);
+		if (sectors > 1) {
+			// the links are shared by all sectors; cache them before the threads
+			// start so that they are not built by each thread
+			SizeType p = lrs_.super().findPartitionNumber(phi.offset(phi.sector(0)));
+			typename ModelType::HamiltonianConnectionType hc(p,
+			                                                 lrs_,
+			                                                 model_.geometry(),
+			                                                 model_.linkProduct(),
+			                                                 currentTime_,
+			                                                 0);
+		}
+
+		Instrumentation::Timer timer("rungeKutta");
+		Instrumentation::Suspend suspend(sectors > 1);
+		NoNestedThreads noNestedThreads(sectors > 1);
+		typedef PsimagLite::Parallelizer<ParallelRungeKutta> ParallelizerType;
+		ParallelizerType parallelRk(sectorParams);
+		parallelRk.loopCreate(helper);
+
+		for (SizeType ii=0;ii<sectors;ii++) {
+			SizeType i0 = phi.sector(ii);
+			for (SizeType i=0;i<startEnd.second;i++)
+				targetVectors_[i].setDataInSector(helper.result(ii, i),i0);
+
+			PsimagLite::OstringStream msg2;
+			msg2<<"Sector "<<i0<<" of size "<<phi.effectiveSize(i0);
+			msg2<<" needed "<<helper.matvecs(ii)<<" matrix-vector products";
+			progress_.printline(msg2,std::cout);
 		}
 	}
 
 private:
 
+	// f(y) = -i timeDirection (H - E0) y, or -timeDirection (H - E0) y if real
 	class FunctionForRungeKutta {
 
 	public:
@@ -181,56 +220,225 @@ private:
 		                      const VectorWithOffsetType& phi,
 		                      SizeType i0)
 			: E0_(E0),
-		      timeDirection_(timeDirection),
+			  factor_(timeDirection*minusOneOrMinusI(static_cast<ComplexOrRealType>(0))),
 			  p_(lrs.super().findPartitionNumber(phi.offset(i0))),
 		      hc_(p_, lrs, model.geometry(), model.linkProduct(), currentTime, 0),
 			  lanczosHelper_(model, hc_)
 		{}
 
-		TargetVectorType operator()(const RealType&,const TargetVectorType& y) const
+		// x = f(y), in place; the shift and the factor are applied as the
+		// product is read
+		void operator()(TargetVectorType& x, const TargetVectorType& y) const
 		{
-			TargetVectorType x(y.size());
+			std::fill(x.begin(), x.end(), 0.0);
 			lanczosHelper_.matrixVectorProduct(x,y);
-			for (SizeType i=0;i<x.size();i++) x[i] -= E0_*y[i];
-			ComplexOrRealType icomplex = minusOneOrMinusI(static_cast<ComplexOrRealType>(0));
-			ComplexOrRealType tmp2 = timeDirection_*icomplex;
-			TargetVectorType x2;
-			x2 <= tmp2*x;
-			return x2;
+			SizeType n = x.size();
+			for (SizeType i=0;i<n;i++)
+				x[i] = factor_*(x[i] - E0_*y[i]);
 		}
 
+		SizeType products() const { return lanczosHelper_.products(); }
+
 	private:
 
+		FunctionForRungeKutta(const FunctionForRungeKutta&);
+
+		FunctionForRungeKutta& operator=(const FunctionForRungeKutta&);
+
 		RealType E0_;
-		RealType timeDirection_;
+		ComplexOrRealType factor_;
 		SizeType p_;
 		typename ModelType::HamiltonianConnectionType hc_;
 		typename LanczosSolverType::LanczosMatrixType lanczosHelper_;
 	}; // FunctionForRungeKutta
 
-	void calcTimeVectors(const PairType& startEnd,
-	                     RealType Eg,
-	                     const VectorWithOffsetType& phi,
-	                     SizeType,
-	                     SizeType i0)
-	{
-		SizeType total = phi.effectiveSize(i0);
-		TargetVectorType phi0(total);
-		phi.extract(phi0,i0);
-		FunctionForRungeKutta f(E0_,tstStruct_.timeDirection(),lrs_,currentTime_,model_,phi,i0);
+	/* One task per sector of phi, that integrates it over the times_.size()
+	   times, at tau/(times_.size()-1) from each other, with RK4 steps of
+	   that size, or, if TSPRungeKuttaTolerance is positive, with
+	   Dormand-Prince 5(4) steps chosen so that the error of each is below
+	   the tolerance. The stages use buffers allocated once per sector.
+	   Each task builds the function of its sector, and so its
+	   HamiltonianConnection, and frees it when done, so that only as many
+	   are alive as there are threads. */
+	class ParallelRungeKutta {
 
-		RealType epsForRK = tstStruct_.tau()/(times_.size()-1.0);
-		PsimagLite::RungeKutta<RealType,FunctionForRungeKutta,TargetVectorType>
-		        rungeKutta(f,epsForRK);
+	public:
 
-		typename PsimagLite::Vector<TargetVectorType>::Type result;
-		rungeKutta.solve(result,0.0,times_.size(),phi0);
-		assert(result.size()==times_.size());
+		ParallelRungeKutta(const TimeVectorsRungeKutta& tv,
+		                   const VectorWithOffsetType& phi)
+		    : tv_(tv),
+		      phi_(phi),
+		      steps_(tv.times_.size()),
+		      dt_((steps_ > 1) ? tv.tstStruct_.tau()/(steps_ - 1.0) : 0.0),
+		      tolerance_(tv.tstStruct_.rungeKuttaTolerance()),
+		      matvecs_(phi.sectors(), 0),
+		      results_(phi.sectors())
+		{}
 
-		for (SizeType i=0;i<startEnd.second;i++) {
-			targetVectors_[i].setDataInSector(result[i],i0);
+		SizeType tasks() const { return results_.size(); }
+
+		void doTask(SizeType ii, SizeType)
+		{
+			SizeType i0 = phi_.sector(ii);
+			FunctionForRungeKutta f(tv_.E0_,
+			                        tv_.tstStruct_.timeDirection(),
+			                        tv_.lrs_,
+			                        tv_.currentTime_,
+			                        tv_.model_,
+			                        phi_,
+			                        i0);
+			VectorTargetVectorType& result = results_[ii];
+			result.resize(steps_);
+			result[0].resize(phi_.effectiveSize(i0));
+			phi_.extract(result[0],i0);
+
+			if (tolerance_ > 0)
+				dormandPrince(result, f);
+			else
+				rk4(result, f);
+
+			matvecs_[ii] = f.products();
 		}
-	}
+
+		const TargetVectorType& result(SizeType ii, SizeType i) const
+		{
+			return results_[ii][i];
+		}
+
+		SizeType matvecs(SizeType ii) const { return matvecs_[ii]; }
+
+	private:
+
+		ParallelRungeKutta(const ParallelRungeKutta&);
+
+		ParallelRungeKutta& operator=(const ParallelRungeKutta&);
+
+		void rk4(VectorTargetVectorType& result, const FunctionForRungeKutta& f) const
+		{
+			SizeType n = result[0].size();
+			TargetVectorType y = result[0];
+			VectorTargetVectorType k(4, TargetVectorType(n));
+			TargetVectorType ytmp(n);
+			RealType h = dt_;
+
+			for (SizeType step=1;step<steps_;step++) {
+				f(k[0], y);
+				combine(ytmp, y, 0.5*h, k[0]);
+				f(k[1], ytmp);
+				combine(ytmp, y, 0.5*h, k[1]);
+				f(k[2], ytmp);
+				combine(ytmp, y, h, k[2]);
+				f(k[3], ytmp);
+				for (SizeType i=0;i<n;i++)
+					y[i] += (h/6.0)*(k[0][i] + 2.0*k[1][i] + 2.0*k[2][i] + k[3][i]);
+
+				result[step] = y;
+			}
+		}
+
+		// Dormand-Prince 5(4), with the last stage of a step reused as the first
+		// of the next one, and local extrapolation; fails if the error is not
+		// finite or the step falls below 1e-12 of the time step
+		void dormandPrince(VectorTargetVectorType& result, const FunctionForRungeKutta& f) const
+		{
+			static const RealType a[7][6] = {
+			    {0, 0, 0, 0, 0, 0},
+			    {1.0/5, 0, 0, 0, 0, 0},
+			    {3.0/40, 9.0/40, 0, 0, 0, 0},
+			    {44.0/45, -56.0/15, 32.0/9, 0, 0, 0},
+			    {19372.0/6561, -25360.0/2187, 64448.0/6561, -212.0/729, 0, 0},
+			    {9017.0/3168, -355.0/33, 46732.0/5247, 49.0/176, -5103.0/18656, 0},
+			    {35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84}};
+			// difference between the fifth and the fourth order weights
+			static const RealType e[7] = {71.0/57600, 0, -71.0/16695, 71.0/1920,
+			                              -17253.0/339200, 22.0/525, -1.0/40};
+
+			SizeType n = result[0].size();
+			TargetVectorType y = result[0];
+			VectorTargetVectorType k(7, TargetVectorType(n));
+			TargetVectorType ytmp(n);
+			TargetVectorType error(n);
+			RealType h = dt_;
+			const RealType minStep = 1e-12*dt_;
+
+			f(k[0], y);
+			for (SizeType step=1;step<steps_;step++) {
+				RealType t = 0;
+				while (t < dt_) {
+					bool last = (t + h >= dt_);
+					RealType hStep = (last) ? dt_ - t : h;
+					for (SizeType s=1;s<7;s++) {
+						ytmp = y;
+						for (SizeType j=0;j<s;j++) {
+							if (a[s][j] == 0) continue;
+							RealType c = hStep*a[s][j];
+							for (SizeType i=0;i<n;i++)
+								ytmp[i] += c*k[j][i];
+						}
+
+						f(k[s], ytmp);
+					}
+
+					std::fill(error.begin(), error.end(), 0.0);
+					for (SizeType j=0;j<7;j++) {
+						if (e[j] == 0) continue;
+						RealType c = hStep*e[j];
+						for (SizeType i=0;i<n;i++)
+							error[i] += c*k[j][i];
+					}
+
+					RealType errorNorm = PsimagLite::norm(error);
+					if (!std::isfinite(errorNorm))
+						err("TimeVectorsRungeKutta: error of Dormand-Prince step not finite\n");
+
+					bool accepted = (errorNorm <= tolerance_);
+					if (accepted) {
+						// ytmp holds the fifth order solution, and k[6] f of it
+						t = (last) ? dt_ : t + hStep;
+						y.swap(ytmp);
+						k[0].swap(k[6]);
+					}
+
+					// a step cut to end at a time of the grid does not shrink h
+					if (accepted && hStep < h) continue;
+
+					RealType factor = (errorNorm > 0) ?
+					            0.9*pow(tolerance_/errorNorm, 0.2) : 5.0;
+					if (factor > 5.0) factor = 5.0;
+					if (factor < 0.2) factor = 0.2;
+					h = hStep*factor;
+					if (h > dt_) h = dt_;
+					if (!accepted && h < minStep) {
+						PsimagLite::String str("TimeVectorsRungeKutta: Dormand-Prince step below ");
+						err(str + "1e-12 of tau/(times-1); is TSPRungeKuttaTolerance too small?\n");
+					}
+				}
+
+				result[step] = y;
+			}
+		}
+
+		// dest = y + c*k
+		static void combine(TargetVectorType& dest,
+		                    const TargetVectorType& y,
+		                    RealType c,
+		                    const TargetVectorType& k)
+		{
+			SizeType n = y.size();
+			for (SizeType i=0;i<n;i++)
+				dest[i] = y[i] + c*k[i];
+		}
+
+		const TimeVectorsRungeKutta& tv_;
+		const VectorWithOffsetType& phi_;
+		SizeType steps_;
+		RealType dt_;
+		RealType tolerance_;
+		typename PsimagLite::Vector<SizeType>::Type matvecs_;
+		typename PsimagLite::Vector<VectorTargetVectorType>::Type results_;
+	}; // class ParallelRungeKutta
+
+	friend class ParallelRungeKutta;
 
 	PsimagLite::ProgressIndicator progress_;
 	RealType currentTime_;
@@ -85,6 +85,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <unistd.h>
 #include "Geometry/Geometry.h"
 #include "PsimagLite.h"
+#include "Io/IoSelector.h"
+#include "TypeToString.h"
 
 namespace Dmrg {
 
@@ -165,7 +167,8 @@ public:
 		             ACTION_GREP,
 		             ACTION_FILES,
 		             ACTION_INPUT,
-		             ACTION_ANALYSIS};
+		             ACTION_ANALYSIS,
+		             ACTION_PHASE_TIMINGS};
 
 	typedef typename GrepForLabel::ParametersType ParametersForGrepType;
 
@@ -177,6 +180,8 @@ public:
 	 \item[input] It echoes the input file.
 	 \item[analysis] or analyze. It opines about the needed ``m'' values for this run,
 	 as well as the needed CPU and RAM that will be required.
+	 \item[phaseTimings] It prints as CSV the phase timings of all steps,
+	 as written with SolverOptions=PhaseTimings. (*)
 	 \end{itemize}
 	 */
 	static ActionEnum actionCanonical(PsimagLite::String action)
@@ -186,12 +191,13 @@ public:
 		if (action == "files") return ACTION_FILES;
 		if (action == "input") return ACTION_INPUT;
 		if (action == "analysis" || action == "analyze") return ACTION_ANALYSIS;
+		if (action == "phaseTimings") return ACTION_PHASE_TIMINGS;
 		return ACTION_UNKNOWN;
 	}
 
 	static PsimagLite::String actions()
 	{
-		return "energies | grep | files | input |analysis";
+		return "energies | grep | files | input |analysis | phaseTimings";
 	}
 
 	static void printGrep(PsimagLite::String inputfile,
@@ -212,6 +218,41 @@ public:
 		std::cout<<"Needed m="<<m<<"\n";
 	}
 
+	// One line per step and phase: step,phase,calls,seconds,flops,bytes
+	static void printPhaseTimings(PsimagLite::String filename)
+	{
+		PsimagLite::IoSelector::In io(filename);
+		SizeType total = 0;
+		try {
+			io.read(total, "PhaseTimings/Size");
+		} catch (...) {
+			err("printPhaseTimings: no PhaseTimings in " + filename +
+			    "; was SolverOptions=PhaseTimings set?\n");
+		}
+
+		std::cout<<"step,phase,calls,seconds,flops,bytes\n";
+		for (SizeType step = 0; step < total; ++step) {
+			PsimagLite::String prefix = "PhaseTimings/" + ttos(step);
+			PsimagLite::String phases;
+			io.read(phases, prefix + "/Phases");
+			PsimagLite::Vector<PsimagLite::String>::Type names;
+			PsimagLite::split(names, phases, ",");
+			for (SizeType i = 0; i < names.size(); ++i) {
+				PsimagLite::String label = prefix + "/" + names[i];
+				SizeType calls = 0;
+				double seconds = 0;
+				SizeType flops = 0;
+				SizeType bytes = 0;
+				io.read(calls, label + "/Calls");
+				io.read(seconds, label + "/Seconds");
+				io.read(flops, label + "/Flops");
+				io.read(bytes, label + "/Bytes");
+				std::cout<<step<<","<<names[i]<<","<<calls<<","<<seconds;
+				std::cout<<","<<flops<<","<<bytes<<"\n";
+			}
+		}
+	}
+
 private:
 
 	static PairSizeStringType findLargestGeometry(const GeometryType& geometry)
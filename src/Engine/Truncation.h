@@ -85,6 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Sort.h"
 #include "Concurrency.h"
 #include "Io/IoNg.h"
+#include "Instrumentation.h"
 
 namespace Dmrg {
 
@@ -152,6 +153,7 @@ public:
 	                       SizeType keptStates,
 	                       ProgramGlobals::DirectionEnum direction)
 	{
+		Instrumentation::Timer timer("truncation");
 		DensityMatrixBaseType* dmS = 0;
 
 		if (direction == ProgramGlobals::EXPAND_SYSTEM) {
@@ -183,6 +185,7 @@ public:
 	                         const TargetingType& target,
 	                         SizeType keptStates)
 	{
+		Instrumentation::Timer timer("truncation");
 		DensityMatrixBaseType* dmS = 0;
 		changeBasis(sBasis,target, keptStates, ProgramGlobals::EXPAND_SYSTEM, &dmS);
 		assert(dmS);
@@ -234,24 +237,30 @@ private:
 		TruncationCache& cache = (direction == ProgramGlobals::EXPAND_SYSTEM) ? leftCache_ :
 		                                                                        rightCache_;
 
-		if (BasisType::useSu2Symmetry()) {
-			if (p.useSvd) {
-				std::cerr<<"WARNING: SVD for truncation NOT supported with SU(2)\n";
-				p.useSvd = false;
+		{
+			Instrumentation::Timer timer("densityMatrix");
+			if (BasisType::useSu2Symmetry()) {
+				if (p.useSvd) {
+					std::cerr<<"WARNING: SVD for truncation NOT supported with SU(2)\n";
+					p.useSvd = false;
+				}
+
+				*dm = new DensityMatrixSu2Type(target,lrs_,p);
+			} else if (p.useSvd) {
+				*dm = new DensityMatrixSvdType(target,lrs_,p);
+			} else {
+				*dm = new DensityMatrixLocalType(target,lrs_,p);
 			}
-
-			*dm = new DensityMatrixSu2Type(target,lrs_,p);
-		} else if (p.useSvd) {
-			*dm = new DensityMatrixSvdType(target,lrs_,p);
-		} else {
-			*dm = new DensityMatrixLocalType(target,lrs_,p);
 		}
 
 		assert(*dm);
 		DensityMatrixBaseType* dmS = *dm;
 		assert(dmS);
 
-		dmS->diag(cache.eigs,'V');
+		{
+			Instrumentation::Timer timer((p.useSvd) ? "svd" : "densityMatrixDiag");
+			dmS->diag(cache.eigs,'V');
+		}
 
 		updateKeptStates(keptStates, cache.eigs);
 
@@ -263,6 +272,7 @@ private:
 			cache.transform.setTo(1.0);
 		}
 
+		Instrumentation::Timer timer("changeOfBasis");
 		rSprime = pBasis;
 		rSprime.changeBasis(cache.removedIndices,cache.eigs,keptStates,parameters_);
 
@@ -294,12 +304,16 @@ private:
 		const PsimagLite::String str = (expandSys) ? "system" : "environ";
 		PsimagLite::OstringStream msg0;
 		msg0<<"Truncating transform for "<<str<<" ...";
-		cache.transform.truncate(cache.removedIndices);
 		progress_.printline(msg0, std::cout);
-		rPrime.truncateBasis(cache.transform,
-		                     cache.eigs,
-		                     cache.removedIndices,
-		                     startEnd);
+		{
+			Instrumentation::Timer timer("changeOfBasis");
+			cache.transform.truncate(cache.removedIndices);
+			rPrime.truncateBasis(cache.transform,
+			                     cache.eigs,
+			                     cache.removedIndices,
+			                     startEnd);
+		}
+
 		LeftRightSuperType* lrs = 0;
 		if (expandSys)
 			lrs = new LeftRightSuperType(rPrime,
@@ -314,6 +328,7 @@ private:
 		bool wftInPatches = (waveFunctionTransformation_.options().accel ==
 		                     WaveFunctionTransfType::WftOptionsType::ACCEL_PATCHES);
 		const LeftRightSuperType& lrsForWft = (twoSiteDmrg || wftInPatches) ? lrs_ : *lrs;
+		Instrumentation::Timer timer("wft");
 		waveFunctionTransformation_.push(cache.transform,
 		                                 direction,
 		                                 lrsForWft,
@@ -86,6 +86,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Parallel2PointCorrelations.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "NoNestedThreads.h"
 
 namespace Dmrg {
 
@@ -101,6 +102,7 @@ class TwoPointCorrelations {
 	typedef typename VectorType::value_type FieldType;
 	typedef typename BasisWithOperatorsType::RealType RealType;
 	typedef TwoPointCorrelations<CorrelationsSkeletonType> ThisType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	static SizeType const GROW_RIGHT = CorrelationsSkeletonType::GROW_RIGHT;
 	static SizeType const GROW_LEFT = CorrelationsSkeletonType::GROW_LEFT;
@@ -116,6 +118,25 @@ public:
 	typedef Parallel2PointCorrelations<ThisType> Parallel2PointCorrelationsType;
 	typedef typename Parallel2PointCorrelationsType::PairType PairType;
 
+	// <O1_i O2_j> into (*w)(i,j)
+	struct Correlator {
+
+		Correlator(MatrixType* w_,
+		           const SparseMatrixType& O1_,
+		           const SparseMatrixType& O2_,
+		           int fermionicSign_)
+		    : w(w_), O1(O1_), O2(O2_), fermionicSign(fermionicSign_)
+		{}
+
+		MatrixType* w;
+		SparseMatrixType O1;
+		SparseMatrixType O2;
+		int fermionicSign;
+	}; // struct Correlator
+
+	typedef typename PsimagLite::Vector<Correlator>::Type VectorCorrelatorType;
+	typedef Parallel2PointRows<ThisType> Parallel2PointRowsType;
+
 	TwoPointCorrelations(ObserverHelperType& helper,
 	                     CorrelationsSkeletonType& skeleton,
 	                     bool verbose=false)
@@ -141,13 +162,125 @@ public:
 		}
 
 		typedef PsimagLite::Parallelizer<Parallel2PointCorrelationsType> ParallelizerType;
-		ParallelizerType threaded2Points(PsimagLite::Concurrency::codeSectionParams);
-
 		Parallel2PointCorrelationsType helper2Points(w,*this,pairs,O1,O2,fermionicSign);
 
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threaded2Points(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
 		threaded2Points.loopCreate(helper2Points);
 	}
 
+	// All correlators in one pass: the threads take rows i, and each
+	// different O1 is grown from i once, one site at a time, for all j
+	// and all the correlators that share it
+	void operator()(const VectorCorrelatorType& correlators)
+	{
+		SizeType total = correlators.size();
+		if (total == 0) return;
+
+		VectorSizeType uniqueO1(total);
+		SizeType rows = 0;
+		for (SizeType c = 0; c < total; ++c) {
+			const Correlator& correlator = correlators[c];
+			SizeType u = 0;
+			for (; u < c; ++u) {
+				if (uniqueO1[u] != u) continue;
+				const Correlator& other = correlators[u];
+				if (other.fermionicSign == correlator.fermionicSign &&
+				        equalMatrices(other.O1, correlator.O1)) break;
+			}
+
+			uniqueO1[c] = u;
+			if (correlator.w->n_row() > rows) rows = correlator.w->n_row();
+		}
+
+		typedef PsimagLite::Parallelizer<Parallel2PointRowsType> ParallelizerType;
+		Parallel2PointRowsType helperRows(*this, correlators, uniqueO1, rows);
+
+		NoNestedThreads noNestedThreads;
+		ParallelizerType threadedRows(PsimagLite::CodeSectionParams(noNestedThreads.threads()));
+		threadedRows.loopCreate(helperRows);
+	}
+
+	// Row i of all correlators; uniqueO1[c] is the first correlator with the O1 of c
+	void calcRow(SizeType i,
+	             const VectorCorrelatorType& correlators,
+	             const VectorSizeType& uniqueO1,
+	             SizeType threadId)
+	{
+		SizeType total = correlators.size();
+		SizeType cols = 0;
+		for (SizeType c = 0; c < total; ++c) {
+			const Correlator& correlator = correlators[c];
+			if (i >= correlator.w->n_row() || i >= correlator.w->n_col()) continue;
+			if (correlator.w->n_col() > cols) cols = correlator.w->n_col();
+			(*correlator.w)(i,i) = calcDiagonalCorrelation(i,
+			                                               correlator.O1,
+			                                               correlator.O2,
+			                                               correlator.fermionicSign,
+			                                               threadId);
+		}
+
+		SizeType n = skeleton_.numberOfSites(threadId);
+		typename PsimagLite::Vector<SparseMatrixType>::Type grown(total);
+		int nt = i - 1;
+		if (nt < 0) nt = 0;
+		SizeType level = nt;
+		for (SizeType c = 0; c < total; ++c)
+			if (uniqueO1[c] == c)
+				skeleton_.createWithModification(grown[c], correlators[c].O1, 'n');
+
+		for (SizeType j = i + 1; j < cols; ++j) {
+			bool corner = (j == n - 1);
+			if (corner && i == j - 1) {
+				for (SizeType c = 0; c < total; ++c) {
+					const Correlator& correlator = correlators[c];
+					if (!inRange(correlator, i, j)) continue;
+					(*correlator.w)(i,j) = calcCorrelation_(i,
+					                                        j,
+					                                        correlator.O1,
+					                                        correlator.O2,
+					                                        correlator.fermionicSign,
+					                                        threadId);
+				}
+
+				continue;
+			}
+
+			SizeType ns = (corner) ? j - 2 : j - 1;
+			for (; level < ns; ++level) {
+				for (SizeType c = 0; c < total; ++c) {
+					if (uniqueO1[c] != c) continue;
+					skeleton_.growStep(grown[c],
+					                   i,
+					                   correlators[c].fermionicSign,
+					                   level,
+					                   threadId);
+				}
+			}
+
+			for (SizeType c = 0; c < total; ++c) {
+				const Correlator& correlator = correlators[c];
+				if (!inRange(correlator, i, j)) continue;
+
+				const SparseMatrixType& O1g = grown[uniqueO1[c]];
+				SparseMatrixType O2m;
+				skeleton_.createWithModification(O2m,correlator.O2,'n');
+				if (corner) {
+					helper_.setPointer(threadId,j-2);
+					(*correlator.w)(i,j) = skeleton_.bracketRightCorner(O1g,
+					                                                    O2m,
+					                                                    correlator.fermionicSign,
+					                                                    threadId);
+					continue;
+				}
+
+				SparseMatrixType O2g;
+				skeleton_.dmrgMultiply(O2g,O1g,O2m,correlator.fermionicSign,ns,threadId);
+				(*correlator.w)(i,j) = skeleton_.bracket(O2g,1,threadId);
+			}
+		}
+	}
+
 	// Return the vector: O1 * O2 |psi>
 	// where |psi> is the g.s.
 	// Note1: O1 is applied to site i and O2 is applied to site j
@@ -229,6 +362,28 @@ private:
 		return skeleton_.bracket(O2g,1,threadId);
 	}
 
+	static bool inRange(const Correlator& correlator, SizeType i, SizeType j)
+	{
+		return (i < correlator.w->n_row() && j < correlator.w->n_col());
+	}
+
+	static bool equalMatrices(const SparseMatrixType& a, const SparseMatrixType& b)
+	{
+		SizeType rows = a.rows();
+		if (rows != b.rows() || a.cols() != b.cols() || a.nonZeros() != b.nonZeros())
+			return false;
+
+		for (SizeType i = 0; i < rows; ++i) {
+			if (a.getRowPtr(i + 1) != b.getRowPtr(i + 1)) return false;
+			for (int k = a.getRowPtr(i); k < a.getRowPtr(i + 1); ++k) {
+				if (a.getCol(k) != b.getCol(k)) return false;
+				if (a.getValue(k) != b.getValue(k)) return false;
+			}
+		}
+
+		return true;
+	}
+
 	SparseMatrixType identity(SizeType n)
 	{
 		SparseMatrixType ret(n,n);
@@ -98,6 +98,7 @@ public:
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef std::pair<SizeType, QnType> PairQnType;
 	typedef typename QnType::PairSizeType PairSizeType;
+	typedef typename PsimagLite::Vector<const ThisType*>::Type VectorConstPointerType;
 
 	static const ComplexOrRealType zero_;
 
@@ -182,6 +183,41 @@ public:
 		}
 	}
 
+	// As fromFull, for a vector given by the data v[ii] of its sectors
+	// sectors[ii] of someBasis only
+	template<typename SomeBasisType>
+	void fromSectors(const typename PsimagLite::Vector<VectorType>::Type& v,
+	                 const VectorSizeType& sectors,
+	                 const SomeBasisType& someBasis)
+	{
+		assert(v.size() == sectors.size());
+		size_ = someBasis.size();
+		SizeType found = 0;
+		SizeType nonZeroSectors = 0;
+		for (SizeType ii = 0; ii < v.size(); ++ii) {
+			if (!nonZero(v[ii])) continue;
+			found = ii;
+			++nonZeroSectors;
+		}
+
+		if (nonZeroSectors != 1) {
+			if (nonZeroSectors == 0)
+				std::cout<<"VectorWithOffset:: No partition found\n";
+			else
+				std::cout<<"FATAL: VectorWithOffset:: More than one partition found\n";
+			offset_ = 0;
+			data_.resize(0);
+			return;
+		}
+
+		SizeType m = sectors[found];
+		assert(v[found].size() == someBasis.partition(m + 1) - someBasis.partition(m));
+		offset_ = someBasis.partition(m);
+		const QnType& qn = someBasis.pseudoQn(m);
+		mAndq_ = PairQnType(m, qn);
+		data_ = v[found];
+	}
+
 	SizeType sectors() const { return (size_ == 0) ? 0 : 1; }
 
 	SizeType sector(SizeType) const { return mAndq_.first; }
@@ -346,6 +382,40 @@ public:
 		return PsimagLite::norm(v.data_);
 	}
 
+	// dest = sum_k c[k] (*vs[k]); dest may be one of vs
+	static void linearCombination(VectorWithOffset& dest,
+	                              const VectorType& c,
+	                              const VectorConstPointerType& vs)
+	{
+		assert(c.size() == vs.size());
+		const VectorWithOffset* first = 0;
+		for (SizeType k = 0; k < vs.size(); ++k) {
+			if (vs[k]->size_ == 0) continue;
+			if (!first) first = vs[k];
+			if (vs[k]->offset_ != first->offset_ || vs[k]->mAndq_ != first->mAndq_)
+				err("VectorWithOffset::linearCombination: different sectors\n");
+		}
+
+		if (!first) {
+			dest.clear();
+			return;
+		}
+
+		SizeType total = first->data_.size();
+		VectorType data(total, 0.0);
+		for (SizeType j = 0; j < total; ++j) {
+			ComplexOrRealType sum = 0.0;
+			for (SizeType k = 0; k < vs.size(); ++k)
+				if (vs[k]->size_ > 0) sum += c[k]*vs[k]->data_[j];
+			data[j] = sum;
+		}
+
+		dest.size_ = first->size_;
+		dest.offset_ = first->offset_;
+		dest.mAndq_ = first->mAndq_;
+		dest.data_.swap(data);
+	}
+
 private:
 
 	template<typename SomeBasisType>
@@ -396,6 +466,14 @@ private:
 		return false;
 	}
 
+	static bool nonZero(const VectorType& v)
+	{
+		typename VectorType::value_type zero = 0;
+		for (SizeType j = 0; j < v.size(); ++j)
+			if (v[j] != zero) return true;
+		return false;
+	}
+
 	PsimagLite::ProgressIndicator progress_;
 	SizeType size_;
 	VectorType data_;
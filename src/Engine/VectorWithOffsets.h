@@ -83,8 +83,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Complex.h"
 #include "ProgressIndicator.h"
 #include <cassert>
+#include <algorithm>
 #include "ProgramGlobals.h"
 #include <typeinfo>
+#include "Concurrency.h"
+#include "Parallelizer.h"
 
 // FIXME: a more generic solution is needed instead of tying
 // the non-zero structure to basis
@@ -105,6 +108,65 @@ public:
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef std::pair<SizeType, QnType> PairQnType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<const ThisType*>::Type VectorConstPointerType;
+
+private:
+
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef typename PsimagLite::Vector<int>::Type VectorIntType;
+
+	/* One task per sector of the result, data[i] = sum_k c[k] vs[k].data_[i]
+	   for each sector i in sectors, in one pass over the sector */
+	class ParallelCombination {
+
+	public:
+
+		ParallelCombination(VectorVectorType& data,
+		                    const VectorSizeType& sectors,
+		                    const VectorType& c,
+		                    const VectorConstPointerType& vs)
+		    : data_(data), sectors_(sectors), c_(c), vs_(vs)
+		{}
+
+		SizeType tasks() const { return sectors_.size(); }
+
+		void doTask(SizeType ii, SizeType)
+		{
+			SizeType i = sectors_[ii];
+			VectorSizeType which;
+			typename PsimagLite::Vector<const ComplexOrRealType*>::Type data;
+			for (SizeType k = 0; k < vs_.size(); ++k) {
+				if (!vs_[k]->hasSector(i) || vs_[k]->data_[i].size() == 0) continue;
+				which.push_back(k);
+				data.push_back(&(vs_[k]->data_[i][0]));
+			}
+
+			if (which.size() == 0) return;
+
+			SizeType total = vs_[which[0]]->data_[i].size();
+			VectorType& dest = data_[i];
+			dest.resize(total);
+			SizeType m = which.size();
+			for (SizeType j = 0; j < total; ++j) {
+				ComplexOrRealType sum = 0.0;
+				for (SizeType k = 0; k < m; ++k)
+					sum += c_[which[k]]*data[k][j];
+				dest[j] = sum;
+			}
+		}
+
+	private:
+
+		VectorVectorType& data_;
+		const VectorSizeType& sectors_;
+		const VectorType& c_;
+		const VectorConstPointerType& vs_;
+	}; // class ParallelCombination
+
+	friend class ParallelDots;
+	friend class ParallelCombination;
+
+public:
 
 	VectorWithOffsets()
 	    : progress_("VectorWithOffsets"),size_(0),index2Sector_(0)
@@ -140,6 +202,7 @@ public:
 		data_.clear();
 		offsets_.clear();
 		nzMsAndQns_.clear();
+		sectorIndex_.clear();
 	}
 
 	template<typename SomeBasisType>
@@ -305,6 +368,44 @@ public:
 		setIndex2Sector();
 	}
 
+	// As fromFull, for a vector given by the data v[ii] of its sectors
+	// sectors[ii] of someBasis only
+	template<typename SomeBasisType>
+	void fromSectors(const typename PsimagLite::Vector<VectorType>::Type& v,
+	                 const VectorSizeType& sectors,
+	                 const SomeBasisType& someBasis)
+	{
+		assert(v.size() == sectors.size());
+		size_ = someBasis.size();
+
+		offsets_.resize(someBasis.partition());
+		for (SizeType i=0;i<someBasis.partition();i++)
+			offsets_[i] = someBasis.partition(i);
+		assert(offsets_[offsets_.size()-1]==size_);
+
+		data_.clear();
+		data_.resize(someBasis.partition()-1);
+
+		nzMsAndQns_.clear();
+		for (SizeType jj = 0; jj < sectors.size(); ++jj) {
+			if (!nonZero(v[jj])) continue;
+			SizeType j = sectors[jj];
+			assert(j < data_.size());
+			assert(v[jj].size() == offsets_[j+1] - offsets_[j]);
+			data_[j] = v[jj];
+			const QnType& qn = someBasis.pseudoQn(j);
+			nzMsAndQns_.push_back(PairQnType(j, qn));
+		}
+
+		if (nzMsAndQns_.size() == 0) {
+			PsimagLite::OstringStream msg;
+			msg<<"No partition found";
+			progress_.printline(msg,std::cout);
+		}
+
+		setIndex2Sector();
+	}
+
 	void extract(VectorType& v,SizeType i) const
 	{
 		if (i >= data_.size())
@@ -406,6 +507,8 @@ public:
 			io.read(nzMsAndQns_[i].first, label + "/nzMsAndQns_/" + ttos(i) + "/0");
 			nzMsAndQns_[i].second.read(label + "/nzMsAndQns_/" + ttos(i) + "/1", io);
 		}
+
+		setIndex2Sector();
 	}
 
 	template<typename SomeIoOutputType>
@@ -517,9 +620,11 @@ public:
 		std::cerr<<s<<" norm= "<<norma<<"\n";
 		assert(fabs(norma)>eps);
 
-		for (SizeType i=0;i<v.data_.size();i++)
-			for (SizeType j=0;j<v.data_[i].size();j++)
-				v.data_[i][j] /= norma;
+		for (SizeType ii = 0; ii < v.nzMsAndQns_.size(); ++ii) {
+			VectorType& x = v.data_[v.nzMsAndQns_[ii].first];
+			for (SizeType j = 0; j < x.size(); ++j)
+				x[j] /= norma;
+		}
 	}
 
 	friend ComplexOrRealType operator*(const VectorWithOffsets& v1,
@@ -528,12 +633,12 @@ public:
 		ComplexOrRealType sum = 0;
 		for (SizeType ii = 0; ii < v1.sectors(); ++ii) {
 			SizeType i = v1.sector(ii);
-			for (SizeType jj = 0; jj < v1.sectors(); ++jj) {
-				SizeType j = v2.sector(jj);
-				if (i != j) continue;
-				for (SizeType k = 0; k < v1.effectiveSize(i); ++k)
-					sum+= v1.fastAccess(i,k)*PsimagLite::conj(v2.fastAccess(j,k));
-			}
+			if (!v2.hasSector(i)) continue;
+			const VectorType& x1 = v1.data_[i];
+			const VectorType& x2 = v2.data_[i];
+			assert(x1.size() == x2.size());
+			for (SizeType k = 0; k < x1.size(); ++k)
+				sum += x1[k]*PsimagLite::conj(x2[k]);
 		}
 
 		return sum;
@@ -561,7 +666,7 @@ public:
 			err(s.c_str());
 
 		for (SizeType ii=0;ii<v1.nzMsAndQns_.size();ii++) {
-			SizeType i = v1.nzMsAndQns_[ii];
+			SizeType i = v1.nzMsAndQns_[ii].first;
 			if (i >= v1.data_.size() || i >= v2.data_.size())
 				err(s.c_str());
 			if (v1.data_[i].size()!=v2.data_[i].size())
@@ -573,22 +678,72 @@ public:
 		return w;
 	}
 
+	// dest = sum_k c[k] (*vs[k]), with the union of the sectors of vs;
+	// dest may be one of vs
+	static void linearCombination(VectorWithOffsets& dest,
+	                              const VectorType& c,
+	                              const VectorConstPointerType& vs)
+	{
+		assert(c.size() == vs.size());
+		const VectorWithOffsets* first = 0;
+		for (SizeType k = 0; k < vs.size(); ++k) {
+			if (vs[k]->size_ == 0) continue;
+			if (!first) first = vs[k];
+			if (vs[k]->offsets_ != first->offsets_)
+				err("VectorWithOffsets::linearCombination: different partitions\n");
+		}
+
+		if (!first) {
+			dest.clear();
+			return;
+		}
+
+		typename PsimagLite::Vector<PairQnType>::Type nzMsAndQns;
+		VectorSizeType sectors;
+		for (SizeType i = 0; i < first->data_.size(); ++i) {
+			for (SizeType k = 0; k < vs.size(); ++k) {
+				if (!vs[k]->hasSector(i)) continue;
+				nzMsAndQns.push_back(vs[k]->nzMsAndQns_[vs[k]->sectorIndex_[i]]);
+				sectors.push_back(i);
+				break;
+			}
+		}
+
+		VectorVectorType data(first->data_.size());
+		typedef PsimagLite::Parallelizer<ParallelCombination> ParallelizerType;
+		ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams);
+		ParallelCombination helper(data, sectors, c, vs);
+		threaded.loopCreate(helper);
+
+		dest.size_ = first->size_;
+		dest.offsets_ = first->offsets_;
+		dest.data_.swap(data);
+		dest.nzMsAndQns_.swap(nzMsAndQns);
+		dest.setIndex2Sector();
+	}
+
 private:
 
+	bool hasSector(SizeType i) const
+	{
+		return (i < sectorIndex_.size() && sectorIndex_[i] >= 0);
+	}
+
+	// Also sets sectorIndex_, the index in nzMsAndQns_ of each sector, or -1
 	void setIndex2Sector()
 	{
-		if (index2Sector_.size()!=size_)
-			index2Sector_.resize(size_);
+		index2Sector_.resize(size_);
+		std::fill(index2Sector_.begin(), index2Sector_.end(), -1);
+		sectorIndex_.resize(data_.size());
+		std::fill(sectorIndex_.begin(), sectorIndex_.end(), -1);
 
-		for (SizeType i = 0; i < size_; ++i) {
-			index2Sector_[i] = -1;
-			for (SizeType jj = 0; jj < nzMsAndQns_.size(); ++jj) {
-				SizeType j = nzMsAndQns_[jj].first;
-				assert(j + 1 < offsets_.size());
-				if (i < offsets_[j] || i >= offsets_[j+1])
-					continue;
+		for (SizeType jj = 0; jj < nzMsAndQns_.size(); ++jj) {
+			SizeType j = nzMsAndQns_[jj].first;
+			assert(j + 1 < offsets_.size() && j < data_.size());
+			SizeType end = std::min(offsets_[j + 1], size_);
+			for (SizeType i = offsets_[j]; i < end; ++i)
 				index2Sector_[i] = j;
-			}
+			sectorIndex_[j] = jj;
 		}
 	}
 
@@ -614,6 +769,14 @@ private:
 		}
 	}
 
+	static bool nonZero(const VectorType& v)
+	{
+		typename VectorType::value_type zero = 0;
+		for (SizeType j = 0; j < v.size(); ++j)
+			if (v[j] != zero) return true;
+		return false;
+	}
+
 	template<typename SomeBasisType>
 	bool nonZeroPartition(const VectorType& v,
 	                      const SomeBasisType& someBasis,SizeType i)
@@ -654,6 +817,7 @@ private:
 	typename PsimagLite::Vector<VectorType>::Type data_;
 	typename PsimagLite::Vector<SizeType>::Type offsets_;
 	typename PsimagLite::Vector<PairQnType>::Type nzMsAndQns_;
+	VectorIntType sectorIndex_;
 }; // class VectorWithOffset
 
 template<typename ComplexOrRealType, typename EffectiveQnType>
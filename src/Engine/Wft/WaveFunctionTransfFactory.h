@@ -133,7 +133,7 @@ public:
 	      filenameIn_(params.checkpoint.filename),
 	      filenameOut_(params.filename),
 	      wftImpl_(0),
-	      rng_(3433117),
+	      rng_(params.randomSeed),
 	      noLoad_(false),
 	      save_(params.options.find("noSaveWft") == PsimagLite::String::npos)
 	{
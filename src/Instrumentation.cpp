@@ -0,0 +1,15 @@
+#include "Instrumentation.h"
+
+namespace Dmrg {
+
+bool Instrumentation::enabled_ = false;
+Instrumentation::VectorSizeType Instrumentation::flops_;
+Instrumentation::VectorSizeType Instrumentation::bytes_;
+Instrumentation::VectorFrameType Instrumentation::stack_;
+Instrumentation::VectorStringType Instrumentation::names_;
+Instrumentation::MapRecordType Instrumentation::records_;
+#ifdef USE_PTHREADS
+pthread_t Instrumentation::master_;
+#endif
+
+}
@@ -51,7 +51,8 @@ bool observeOneFullSweep(IoInputType& io,
                          const ModelType& model,
                          const PsimagLite::String& list,
                          bool hasTimeEvolution,
-                         SizeType orbitals);
+                         SizeType orbitals,
+                         ObserveOutput<typename VectorWithOffsetType::value_type>& output);
 }
 
 #endif // OBSERVEDRIVER_H
@@ -44,23 +44,27 @@ template bool observeOneFullSweep<VectorWithOffset1Type,ModelBase1Type>(IoInputT
 const ModelBase1Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset1Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset2Type,ModelBase2Type>(IoInputType& io,
 const ModelBase2Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset2Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset3Type,ModelBase1Type>(IoInputType& io,
 const ModelBase1Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset3Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset4Type,ModelBase2Type>(IoInputType& io,
 const ModelBase2Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset4Type::value_type>& output);
 }
@@ -45,23 +45,27 @@ template bool observeOneFullSweep<VectorWithOffset1Type,ModelBase3Type>(IoInputT
 const ModelBase3Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset1Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset2Type,ModelBase4Type>(IoInputType& io,
 const ModelBase4Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset2Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset3Type,ModelBase3Type>(IoInputType& io,
 const ModelBase3Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset3Type::value_type>& output);
 
 template bool observeOneFullSweep<VectorWithOffset4Type,ModelBase4Type>(IoInputType& io,
 const ModelBase4Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
-SizeType orbitals);
+SizeType orbitals,
+ObserveOutput<VectorWithOffset4Type::value_type>& output);
 }
@@ -10,7 +10,8 @@ bool observeOneFullSweep(IoInputType& io,
                          const ModelType& model,
                          const PsimagLite::String& list,
                          bool hasTimeEvolution,
-                         SizeType orbitals)
+                         SizeType orbitals,
+                         ObserveOutput<typename VectorWithOffsetType::value_type>& output)
 {
 	typedef typename ModelType::GeometryType GeometryType;
 	typedef Observer<VectorWithOffsetType,ModelType,IoInputType> ObserverType;
@@ -77,7 +78,10 @@ bool observeOneFullSweep(IoInputType& io,
 	                                  start,
 	                                  nf,
 	                                  trail,
-	                                  verbose);
+	                                  verbose,
+	                                  output);
+
+	observerLib.plan(vecOptions,rows,cols,orbitals);
 
 	for (SizeType i = 0; i < vecOptions.size(); ++i) {
 		PsimagLite::String item = vecOptions[i];
@@ -81,25 +81,14 @@ PsimagLite::String basename(PsimagLite::String pathname)
 	                                       UnixPathSeparator()).base(),pathname.end());
 }
 
+// Prepends pre to the basename of pathname, keeping its directory
 PsimagLite::String pathPrepend(PsimagLite::String pre,PsimagLite::String pathname)
 {
-	bool addDotDot = false;
-	PsimagLite::String path1("");
-	if (pathname.length() > 2 && pathname[0] == '.' && pathname[1] == '.') {
-		addDotDot = true;
-		path1 = pathname.substr(2,pathname.length());
-	}
-
-	if (pathname.length() > 1 && pathname[0] == '/') path1 = pathname;
-
-	if (path1 == "") return pre + pathname;
-
-	size_t index = path1.find_last_of("/");
+	size_t index = pathname.find_last_of("/");
+	if (index == PsimagLite::String::npos) return pre + pathname;
 
 	index++;
-	PsimagLite::String ret = path1.substr(0,index) + pre +
-	        path1.substr(index,path1.length());
-	return (addDotDot) ? ".." + ret : ret;
+	return pathname.substr(0,index) + pre + pathname.substr(index,pathname.length());
 }
 
 SizeType exactDivision(SizeType a, SizeType b)
@@ -56,9 +56,11 @@ my %finiteLoopDriver = (name => 'FiniteLoop', aux => 1);
 my %utilsDriver = (name => 'Utils', aux => 1);
 my %qnDriver = (name => 'Qn', aux => 1);
 my %su2RelatedDriver = (name => 'Su2Related', aux => 1);
+my %instrumentationDriver = (name => 'Instrumentation', aux => 1);
 my %toolboxDriver = (name => 'toolboxdmrg',
                      dotos => 'toolboxdmrg.o ProgramGlobals.o Provenance.o Utils.o Qn.o');
 my $dotos = "observe.o ProgramGlobals.o Provenance.o Utils.o Su2Related.o Qn.o ";
+$dotos .= " Instrumentation.o ";
 $dotos .= " ObserveDriver0.o ObserveDriver1.o ObserveDriver2.o ";
 my %observeDriver = (name => 'observe', dotos => $dotos);
 
@@ -68,11 +70,11 @@ my %observeDriver2 = (name => 'ObserveDriver2', aux => 1);
 
 my @drivers = (\%provenanceDriver,\%su2RelatedDriver,
 \%progGlobalsDriver,\%restartDriver,\%finiteLoopDriver,\%utilsDriver,
-\%qnDriver, \%observeDriver,\%toolboxDriver,
+\%qnDriver, \%instrumentationDriver, \%observeDriver,\%toolboxDriver,
 \%observeDriver0,\%observeDriver1,\%observeDriver2);
 
 $dotos = "dmrg.o Provenance.o RestartStruct.o FiniteLoop.o Utils.o Qn.o ";
-$dotos .= " ProgramGlobals.o Su2Related.o";
+$dotos .= " ProgramGlobals.o Su2Related.o Instrumentation.o";
 
 my @su2files = DmrgDriver::createTemplates($generateSources);
 my $templates = scalar(@su2files);
@@ -86,8 +88,9 @@ for (my $i = 0; $i < $templates; ++$i) {
 }
 
 my %dmrgMain = (name => 'dmrg', dotos => "$dotos", libs => "kronutil");
+my %kronReplayDriver = (name => 'kronReplay', dotos => 'kronReplay.o', libs => "kronutil");
 
-push @drivers,\%dmrgMain;
+push @drivers,\%dmrgMain,\%kronReplayDriver;
 
 my $su2flags = ($su2enabled) ? " -DENABLE_SU2 " : "";
 
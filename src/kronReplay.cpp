@@ -0,0 +1,338 @@
+#include <iostream>
+#include <unistd.h>
+#include "PsimagLite.h"
+#include "Vector.h"
+#include "Matrix.h"
+#include "CrsMatrix.h"
+#include "Parallelizer.h"
+#include "ProgressIndicator.h"
+#include "Random48.h"
+#include "KronDumpFormat.h"
+#include "KronUtil/KronUtil.h"
+
+#ifndef USE_FLOAT
+typedef double RealType;
+#else
+typedef float RealType;
+#endif
+typedef PsimagLite::Concurrency ConcurrencyType;
+typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
+
+/* PSIDOC KronReplayDriver
+ kronReplay loads a file written with SolverOptions=KroneckerDumperBinary,
+ and times the superblock matrix-vector product of that dump in isolation,
+ for each kernel and number of threads given. The kernels are
+ \begin{itemize}
+ \item[sector] Row by row over the states of the sector, visiting the
+ nonzeros of Ahat and B, as ModelHelperLocal::fastOpProdInter does.
+ \item[kron] y += kron(B, Ahat) x with csr\_kron\_mult of KronUtil,
+ which chooses its own method from the sparsity of the matrices.
+ \item[dense] Like kron, but with dense matrices and den\_kron\_mult.
+ \end{itemize}
+ The kron and dense kernels work on the whole product space.
+ The command line arguments of kronReplay are the following.
+  \begin{itemize}
+  \item[-f] {[}Mandatory, String{]} The kroneckerDumperN.bin file.
+  \item[-k] {[}Optional, String{]} Comma-separated kernels, defaults to sector,kron.
+  \item[-t] {[}Optional, String{]} Comma-separated thread counts, defaults to 1.
+  \item[-r] {[}Optional, Integer{]} Matrix-vector products per timing, defaults to 10.
+  \item[-c] {[}Optional, no argument needed{]} The dump is complex.
+  \end{itemize}
+*/
+template<typename ComplexOrRealType>
+class KronReplay {
+
+	typedef Dmrg::KronDumpReader<ComplexOrRealType> ReaderType;
+	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+
+public:
+
+	enum KernelEnum {KERNEL_SECTOR, KERNEL_KRON, KERNEL_DENSE};
+
+	KronReplay(const ReaderType& reader)
+	    : reader_(reader),
+	      nl_(reader.leftSize()),
+	      nr_(reader.rightSize()),
+	      x_(nl_*nr_, 0.0),
+	      kernel_(KERNEL_SECTOR)
+	{
+		const VectorSizeType& sector = reader_.sector();
+		PsimagLite::Random48<RealType> rng(1234);
+		for (SizeType i = 0; i < sector.size(); ++i)
+			x_[sector[i]] = rng() - 0.5;
+
+		identity(eyeLeft_, nl_);
+		identity(eyeRight_, nr_);
+	}
+
+	static KernelEnum kernelCanonical(PsimagLite::String name)
+	{
+		if (name == "sector") return KERNEL_SECTOR;
+		if (name == "kron") return KERNEL_KRON;
+		if (name == "dense") return KERNEL_DENSE;
+		err("kronReplay: unknown kernel " + name + "; use sector, kron or dense\n");
+		return KERNEL_SECTOR;
+	}
+
+	// Returns seconds per matrix-vector product; y is restricted to the sector
+	RealType run(KernelEnum kernel, SizeType threads, SizeType repetitions, VectorType& y)
+	{
+		kernel_ = kernel;
+		if (kernel_ == KERNEL_DENSE && dense_.size() == 0) makeDense();
+
+		SizeType storage = ConcurrencyType::storageSize(threads);
+		yThread_.resize(storage);
+		y.resize(reader_.sector().size());
+		y_ = &y;
+
+		PsimagLite::CodeSectionParams codeSection(threads, false);
+		typedef PsimagLite::Parallelizer<KronReplay> ParallelizerType;
+		PsimagLite::MemoryUsage::TimeHandle start = PsimagLite::ProgressIndicator::time();
+		for (SizeType rep = 0; rep < repetitions; ++rep) {
+			clear();
+			ParallelizerType threaded(codeSection);
+			threaded.loopCreate(*this);
+			sum();
+		}
+
+		PsimagLite::MemoryUsage::TimeHandle end = PsimagLite::ProgressIndicator::time();
+		return (end - start).seconds()/repetitions;
+	}
+
+	SizeType tasks() const
+	{
+		return (kernel_ == KERNEL_SECTOR) ? reader_.sector().size() : reader_.links() + 2;
+	}
+
+	void doTask(SizeType taskNumber, SizeType threadNum)
+	{
+		if (kernel_ == KERNEL_SECTOR)
+			sectorRow(taskNumber);
+		else
+			kronTask(taskNumber, threadNum);
+	}
+
+private:
+
+	// y(l + r*nl) = sum HL(l,l') x(l' + r*nl) + HR(r,r') x(l + r'*nl)
+	//             + sum_links Ahat(l,l') B(r,r') x(l' + r'*nl)
+	void sectorRow(SizeType i)
+	{
+		SizeType s = reader_.sector()[i];
+		SizeType l = s % nl_;
+		SizeType r = s / nl_;
+		ComplexOrRealType sum = 0.0;
+
+		const SparseMatrixType& hl = reader_.hamiltonian(0);
+		for (int k = hl.getRowPtr(l); k < hl.getRowPtr(l + 1); ++k)
+			sum += hl.getValue(k)*x_[hl.getCol(k) + r*nl_];
+
+		const SparseMatrixType& hr = reader_.hamiltonian(1);
+		for (int k = hr.getRowPtr(r); k < hr.getRowPtr(r + 1); ++k)
+			sum += hr.getValue(k)*x_[l + hr.getCol(k)*nl_];
+
+		SizeType links = reader_.links();
+		for (SizeType link = 0; link < links; ++link) {
+			const SparseMatrixType& a = reader_.ahat(link);
+			const SparseMatrixType& b = reader_.b(link);
+			for (int kb = b.getRowPtr(r); kb < b.getRowPtr(r + 1); ++kb) {
+				SizeType offset = b.getCol(kb)*nl_;
+				ComplexOrRealType tmp = 0.0;
+				for (int ka = a.getRowPtr(l); ka < a.getRowPtr(l + 1); ++ka)
+					tmp += a.getValue(ka)*x_[a.getCol(ka) + offset];
+				sum += b.getValue(kb)*tmp;
+			}
+		}
+
+		(*y_)[i] = sum;
+	}
+
+	// Task 0 is HL, task 1 is HR, then one task per link
+	void kronTask(SizeType taskNumber, SizeType threadNum)
+	{
+		VectorType& y = yThread_[threadNum];
+		if (y.size() != x_.size()) y.resize(x_.size(), 0.0);
+
+		const RealType denseFlopDiscount = 0.2;
+		if (kernel_ == KERNEL_DENSE) {
+			const MatrixType& a = dense_[2*taskNumber];
+			const MatrixType& b = dense_[2*taskNumber + 1];
+			den_kron_mult('N', 'N', b, a, x_, 0, y, 0, denseFlopDiscount);
+			return;
+		}
+
+		const SparseMatrixType* a = 0;
+		const SparseMatrixType* b = 0;
+		pairFor(&a, &b, taskNumber);
+		csr_kron_mult('N', 'N', *b, *a, x_, 0, y, 0, denseFlopDiscount);
+	}
+
+	void pairFor(const SparseMatrixType** a, const SparseMatrixType** b, SizeType task) const
+	{
+		if (task == 0) {
+			*a = &reader_.hamiltonian(0);
+			*b = &eyeRight_;
+		} else if (task == 1) {
+			*a = &eyeLeft_;
+			*b = &reader_.hamiltonian(1);
+		} else {
+			*a = &reader_.ahat(task - 2);
+			*b = &reader_.b(task - 2);
+		}
+	}
+
+	void makeDense()
+	{
+		SizeType total = reader_.links() + 2;
+		dense_.resize(2*total);
+		for (SizeType task = 0; task < total; ++task) {
+			const SparseMatrixType* a = 0;
+			const SparseMatrixType* b = 0;
+			pairFor(&a, &b, task);
+			crsMatrixToFullMatrix(dense_[2*task], *a);
+			crsMatrixToFullMatrix(dense_[2*task + 1], *b);
+		}
+	}
+
+	void clear()
+	{
+		for (SizeType i = 0; i < yThread_.size(); ++i)
+			std::fill(yThread_[i].begin(), yThread_[i].end(), 0.0);
+	}
+
+	void sum()
+	{
+		if (kernel_ == KERNEL_SECTOR) return;
+
+		const VectorSizeType& sector = reader_.sector();
+		VectorType& y = *y_;
+		for (SizeType i = 0; i < sector.size(); ++i) {
+			y[i] = 0.0;
+			for (SizeType t = 0; t < yThread_.size(); ++t)
+				if (yThread_[t].size() > 0) y[i] += yThread_[t][sector[i]];
+		}
+	}
+
+	static void identity(SparseMatrixType& m, SizeType n)
+	{
+		m = SparseMatrixType(n, n, n);
+		for (SizeType i = 0; i < n; ++i) {
+			m.setRow(i, i);
+			m.setCol(i, i);
+			m.setValues(i, 1.0);
+		}
+
+		m.setRow(n, n);
+		m.checkValidity();
+	}
+
+	const ReaderType& reader_;
+	SizeType nl_;
+	SizeType nr_;
+	VectorType x_;
+	KernelEnum kernel_;
+	VectorType* y_;
+	VectorVectorType yThread_;
+	SparseMatrixType eyeLeft_;
+	SparseMatrixType eyeRight_;
+	VectorMatrixType dense_;
+}; // class KronReplay
+
+void usage(const PsimagLite::String& name)
+{
+	std::cerr<<"USAGE is "<<name<<" -f kroneckerDumperN.bin [-k kernels] ";
+	std::cerr<<"[-t threads] [-r repetitions] [-c]\n";
+}
+
+template<typename ComplexOrRealType>
+void main1(PsimagLite::String filename,
+           const VectorStringType& kernels,
+           const VectorSizeType& threads,
+           SizeType repetitions)
+{
+	typedef Dmrg::KronDumpReader<ComplexOrRealType> ReaderType;
+	typedef KronReplay<ComplexOrRealType> KronReplayType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+
+	ReaderType reader(filename);
+	std::cout<<"Instance="<<reader.instance()<<" left="<<reader.leftSize();
+	std::cout<<" right="<<reader.rightSize()<<" sector="<<reader.sector().size();
+	std::cout<<" links="<<reader.links()<<"\n";
+
+	KronReplayType replay(reader);
+	VectorType yReference;
+	std::cout<<"kernel threads secondsPerMatvec matvecsPerSecond maxDiff\n";
+	for (SizeType i = 0; i < kernels.size(); ++i) {
+		typename KronReplayType::KernelEnum kernel = KronReplayType::kernelCanonical(kernels[i]);
+		for (SizeType j = 0; j < threads.size(); ++j) {
+			VectorType y;
+			RealType seconds = replay.run(kernel, threads[j], repetitions, y);
+			if (yReference.size() == 0) yReference = y;
+			RealType maxDiff = 0;
+			for (SizeType k = 0; k < y.size(); ++k) {
+				RealType tmp = PsimagLite::norm(y[k] - yReference[k]);
+				if (tmp > maxDiff) maxDiff = tmp;
+			}
+
+			RealType perSecond = (seconds > 0) ? 1.0/seconds : 0;
+			std::cout<<kernels[i]<<" "<<threads[j]<<" "<<seconds<<" ";
+			std::cout<<perSecond<<" "<<maxDiff<<"\n";
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	PsimagLite::PsiApp application("kronReplay",&argc,&argv,1);
+	PsimagLite::String filename;
+	PsimagLite::String kernelsString("sector,kron");
+	PsimagLite::String threadsString("1");
+	SizeType repetitions = 10;
+	bool isComplex = false;
+	int opt = 0;
+	while ((opt = getopt(argc, argv,"f:k:t:r:c")) != -1) {
+		switch (opt) {
+		case 'f':
+			filename = optarg;
+			break;
+		case 'k':
+			kernelsString = optarg;
+			break;
+		case 't':
+			threadsString = optarg;
+			break;
+		case 'r':
+			repetitions = atoi(optarg);
+			break;
+		case 'c':
+			isComplex = true;
+			break;
+		default:
+			usage(application.name());
+			return 1;
+		}
+	}
+
+	if (filename == "" || repetitions == 0) {
+		usage(application.name());
+		return 1;
+	}
+
+	VectorStringType kernels;
+	PsimagLite::split(kernels, kernelsString, ",");
+	VectorStringType tmp;
+	PsimagLite::split(tmp, threadsString, ",");
+	VectorSizeType threads(tmp.size());
+	for (SizeType i = 0; i < tmp.size(); ++i)
+		threads[i] = atoi(tmp[i].c_str());
+
+	if (isComplex)
+		main1<std::complex<RealType> >(filename, kernels, threads, repetitions);
+	else
+		main1<RealType>(filename, kernels, threads, repetitions);
+}
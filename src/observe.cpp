@@ -37,8 +37,12 @@ void mainLoop(GeometryType& geometry,
 	if (iscomplex != PsimagLite::IsComplexNumber<ComplexOrRealType>::True)
 		err("Previous run was complex and this one is not (or viceversa)\n");
 
+	// one output file for all sweeps
+	ObserveOutput<ComplexOrRealType> output(params.filename, params.options);
 	while (!observeOneFullSweep<VectorWithOffsetType,ModelBaseType>
-	       (dataIo,model,list,hasTimeEvolution,orbitals));
+	       (dataIo,model,list,hasTimeEvolution,orbitals,output));
+
+	output.close();
 }
 
 template<typename GeometryType,
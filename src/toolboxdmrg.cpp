@@ -59,6 +59,8 @@ void main1(InputNgType::Readable& io,
 		str += toolOptions.filename;
 		std::cout<<str<<"\n";
 		ToolBoxType::analize(dmrgSolverParams, geometry, toolOptions.extraOptions);
+	} else if (act == ToolBoxType::ACTION_PHASE_TIMINGS) {
+		ToolBoxType::printPhaseTimings(dmrgSolverParams.filename);
 	} else {
 		std::cerr<<application.name();
 		std::cerr<<": Unknown action "<<toolOptions.action<<"\n";